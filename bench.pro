@@ -0,0 +1,28 @@
+QT += core
+QT -= gui
+
+CONFIG += c++20 console
+CONFIG -= app_bundle
+
+# No -Werror: at -O3 GCC 12 raises a false -Wrestrict positive in the
+# std::string concatenation of SquareToString
+QMAKE_CXXFLAGS += -O3 -Wall
+
+# Benchmark the code as it ships, without the hash consistency checks
+DEFINES += NDEBUG
+
+LIBS += -lbenchmark -lbenchmark_main
+
+include (include/include.pri)
+include (src/src.pri)
+
+# The chess core and the engine parser, without the widgets
+HEADERS = \
+  $$CORE_HEADERS \
+  include/uciengine.hpp
+
+SOURCES = \
+  $$CORE_SOURCES \
+  src/uciengine.cpp
+
+include (bench/bench.pri)
@@ -0,0 +1,11 @@
+HEADERS += \
+    $$PWD/corpus.hpp
+
+SOURCES += \
+    $$PWD/board_bench.cpp \
+    $$PWD/piece_bench.cpp \
+    $$PWD/notation_bench.cpp \
+    $$PWD/search_bench.cpp \
+    $$PWD/uciengine_bench.cpp
+
+INCLUDEPATH += $$PWD
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <benchmark/benchmark.h>
+
+#include "board.hpp"
+#include "corpus.hpp"
+
+namespace {
+
+void BM_BoardCopy(benchmark::State& state) {
+  const chess::Board board = bench::LoadPosition(state.range(0));
+  state.SetLabel(bench::CORPUS[state.range(0)].name);
+
+  for (auto _ : state) {
+    chess::Board copy(board);
+    benchmark::DoNotOptimize(copy);
+  }
+}
+BENCHMARK(BM_BoardCopy)->DenseRange(0, bench::CORPUS_SIZE - 1);
+
+void BM_DoMove(benchmark::State& state) {
+  const chess::Board board = bench::LoadPosition(state.range(0));
+  state.SetLabel(bench::CORPUS[state.range(0)].name);
+  chess::MoveList moves;
+  board.GenerateLegalMoves(moves);
+
+  // Every legal move, each on a fresh copy of the position
+  for (auto _ : state) {
+    for (const chess::Move& move : moves) {
+      chess::Board copy(board);
+      copy.DoMove(move);
+      benchmark::DoNotOptimize(copy);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * moves.Size());
+}
+BENCHMARK(BM_DoMove)->DenseRange(0, bench::CORPUS_SIZE - 1);
+
+void BM_MakeUnmakeMove(benchmark::State& state) {
+  chess::Board board = bench::LoadPosition(state.range(0));
+  state.SetLabel(bench::CORPUS[state.range(0)].name);
+  chess::MoveList moves;
+  board.GenerateLegalMoves(moves);
+  chess::BoardHistory history;
+
+  for (auto _ : state) {
+    for (const chess::Move& move : moves) {
+      board.MakeMove(move, history);
+      board.UnmakeMove(history);
+    }
+    benchmark::DoNotOptimize(board);
+  }
+  state.SetItemsProcessed(state.iterations() * moves.Size());
+}
+BENCHMARK(BM_MakeUnmakeMove)->DenseRange(0, bench::CORPUS_SIZE - 1);
+
+void BM_IsValidMove(benchmark::State& state) {
+  chess::Board board = bench::LoadPosition(state.range(0));
+  state.SetLabel(bench::CORPUS[state.range(0)].name);
+  chess::MoveList moves;
+  board.GenerateMoves(moves);
+  const chess::Colour colour = board.GetSideToMove();
+
+  for (auto _ : state) {
+    for (const chess::Move& move : moves) {
+      benchmark::DoNotOptimize(board.IsValidMove(move, colour));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * moves.Size());
+}
+BENCHMARK(BM_IsValidMove)->DenseRange(0, bench::CORPUS_SIZE - 1);
+
+void BM_IsInCheck(benchmark::State& state) {
+  const chess::Board board = bench::LoadPosition(state.range(0));
+  state.SetLabel(bench::CORPUS[state.range(0)].name);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(board.IsInCheck(chess::Colour::WHITE));
+    benchmark::DoNotOptimize(board.IsInCheck(chess::Colour::BLACK));
+  }
+}
+BENCHMARK(BM_IsInCheck)->DenseRange(0, bench::CORPUS_SIZE - 1);
+
+void BM_GenerateLegalMoves(benchmark::State& state) {
+  const chess::Board board = bench::LoadPosition(state.range(0));
+  state.SetLabel(bench::CORPUS[state.range(0)].name);
+
+  for (auto _ : state) {
+    chess::MoveList moves;
+    board.GenerateLegalMoves(moves);
+    benchmark::DoNotOptimize(moves);
+  }
+}
+BENCHMARK(BM_GenerateLegalMoves)->DenseRange(0, bench::CORPUS_SIZE - 1);
+
+void BM_GetPosition(benchmark::State& state) {
+  const chess::Board board = bench::LoadPosition(state.range(0));
+  state.SetLabel(bench::CORPUS[state.range(0)].name);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(board.GetPosition(board.GetSideToMove()));
+  }
+}
+BENCHMARK(BM_GetPosition)->DenseRange(0, bench::CORPUS_SIZE - 1);
+
+void BM_WriteFEN(benchmark::State& state) {
+  const chess::Board board = bench::LoadPosition(state.range(0));
+  state.SetLabel(bench::CORPUS[state.range(0)].name);
+  chess::Board::FenBuffer buffer;
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(board.WriteFEN(buffer));
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_WriteFEN)->DenseRange(0, bench::CORPUS_SIZE - 1);
+
+void BM_ParseFen(benchmark::State& state) {
+  const std::string fen = bench::CORPUS[state.range(0)].fen;
+  state.SetLabel(bench::CORPUS[state.range(0)].name);
+
+  for (auto _ : state) {
+    chess::Board board;
+    benchmark::DoNotOptimize(board.FromFEN(fen));
+    benchmark::DoNotOptimize(board);
+  }
+}
+BENCHMARK(BM_ParseFen)->DenseRange(0, bench::CORPUS_SIZE - 1);
+
+}  // namespace
@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_BENCH_CORPUS_HPP_
+#define _CHESS_BENCH_CORPUS_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include "board.hpp"
+#include "perft.hpp"
+
+namespace bench {
+
+struct BenchPosition {
+  const char* name;
+  const char* fen;
+};
+
+/**
+ * @brief Fixed set of positions every benchmark runs over: the perft
+ * reference positions, which cover castling, en passant, promotions and pins,
+ * plus a quiet endgame.
+ */
+constexpr std::array<BenchPosition, chess::PERFT_POSITIONS.size() + 1>
+MakeCorpus() {
+  std::array<BenchPosition, chess::PERFT_POSITIONS.size() + 1> corpus{};
+  for (std::size_t i = 0; i < chess::PERFT_POSITIONS.size(); ++i) {
+    corpus[i] = {chess::PERFT_POSITIONS[i].name, chess::PERFT_POSITIONS[i].fen};
+  }
+  corpus.back() = {"endgame", "8/5k2/3p4/1p1Pp2p/pP2Pp1P/P4P1K/8/8 b - - 0 50"};
+  return corpus;
+}
+
+inline constexpr auto CORPUS = MakeCorpus();
+
+constexpr int64_t CORPUS_SIZE = static_cast<int64_t>(CORPUS.size());
+
+inline chess::Board LoadPosition(int64_t index) {
+  chess::Board board;
+  board.SetPosition(CORPUS[index].fen);
+  return board;
+}
+
+/**
+ * @brief Output of a UCI engine analysing the start position with three
+ * lines, as read from its standard output.
+ */
+constexpr const char* RECORDED_ENGINE_OUTPUT =
+    "info depth 1 seldepth 1 multipv 1 score cp 40 nodes 20 nps 10000 "
+    "tbhits 0 time 2 pv e2e4\n"
+    "info depth 1 seldepth 1 multipv 2 score cp 35 nodes 20 nps 10000 "
+    "tbhits 0 time 2 pv d2d4\n"
+    "info depth 1 seldepth 1 multipv 3 score cp 30 nodes 20 nps 10000 "
+    "tbhits 0 time 2 pv g1f3\n"
+    "info depth 10 currmove e2e4 currmovenumber 1\n"
+    "info depth 12 seldepth 16 multipv 1 score cp 38 lowerbound nodes 91234 "
+    "nps 912340 hashfull 30 tbhits 0 time 100 pv e2e4\n"
+    "info depth 12 seldepth 16 multipv 1 score cp 36 nodes 120034 "
+    "nps 923338 hashfull 41 tbhits 0 time 130 pv e2e4 e7e5 g1f3 b8c6 f1b5 "
+    "g8f6 e1g1 f6e4 f1e1 e4d6\n"
+    "info depth 12 seldepth 15 multipv 2 score cp 31 nodes 120034 "
+    "nps 923338 hashfull 41 tbhits 0 time 130 pv d2d4 g8f6 c2c4 e7e6 g1f3 "
+    "d7d5 b1c3 f8e7\n"
+    "info depth 12 seldepth 17 multipv 3 score cp 27 nodes 120034 "
+    "nps 923338 hashfull 41 tbhits 0 time 130 pv g1f3 d7d5 d2d4 g8f6 c2c4 "
+    "e7e6 b1c3 c7c6\n"
+    "info depth 20 seldepth 28 multipv 1 score mate 12 nodes 3120034 "
+    "nps 1023338 hashfull 241 tbhits 0 time 3049 pv e2e4 e7e5 g1f3 b8c6\n"
+    "bestmove e2e4 ponder e7e5";
+
+}  // namespace bench
+
+#endif  // _CHESS_BENCH_CORPUS_HPP_
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "chess.hpp"
+#include "corpus.hpp"
+
+namespace {
+
+void BM_MoveToUCI(benchmark::State& state) {
+  const chess::Board board = bench::LoadPosition(state.range(0));
+  state.SetLabel(bench::CORPUS[state.range(0)].name);
+  chess::MoveList moves;
+  board.GenerateLegalMoves(moves);
+
+  for (auto _ : state) {
+    for (const chess::Move& move : moves) {
+      benchmark::DoNotOptimize(chess::MoveToUCI(move));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * moves.Size());
+}
+BENCHMARK(BM_MoveToUCI)->DenseRange(0, bench::CORPUS_SIZE - 1);
+
+void BM_UCIToMove(benchmark::State& state) {
+  const chess::Board board = bench::LoadPosition(state.range(0));
+  state.SetLabel(bench::CORPUS[state.range(0)].name);
+  chess::MoveList moves;
+  board.GenerateLegalMoves(moves);
+  std::vector<std::string> ucis;
+  for (const chess::Move& move : moves) {
+    ucis.push_back(chess::MoveToUCI(move));
+  }
+
+  for (auto _ : state) {
+    for (const std::string& uci : ucis) {
+      benchmark::DoNotOptimize(chess::UCIToMove(uci));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * ucis.size());
+}
+BENCHMARK(BM_UCIToMove)->DenseRange(0, bench::CORPUS_SIZE - 1);
+
+}  // namespace
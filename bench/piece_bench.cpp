@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include "board.hpp"
+#include "corpus.hpp"
+#include "piece.hpp"
+
+namespace {
+
+/**
+ * @brief GetPieceMoves of one piece type, for every piece of that type in a
+ * corpus position. Arguments: piece type, corpus index.
+ */
+void BM_GetMoves(benchmark::State& state) {
+  const auto type = static_cast<chess::PieceType>(state.range(0));
+  const chess::Board board = bench::LoadPosition(state.range(1));
+  state.SetLabel(std::string{bench::CORPUS[state.range(1)].name} + "/" +
+                 chess::PieceCode(chess::Colour::WHITE, type).GetFenChar());
+
+  std::vector<chess::Square> squares;
+  for (uint8_t index = 0; index < chess::NUM_SQUARES; ++index) {
+    const chess::Position& position = board.GetBitboards();
+    if (!position.IsEmpty(index) && (position.GetType(index) == type)) {
+      squares.push_back(chess::IndexToSquare(index));
+    }
+  }
+
+  for (auto _ : state) {
+    chess::MoveList moves;
+    for (const chess::Square& square : squares) {
+      chess::GetPieceMoves(board, board.GetPiece(square), square, moves);
+    }
+    benchmark::DoNotOptimize(moves);
+  }
+  state.SetItemsProcessed(state.iterations() * squares.size());
+}
+BENCHMARK(BM_GetMoves)
+    ->ArgsProduct({benchmark::CreateDenseRange(0, 5, 1),
+                   benchmark::CreateDenseRange(0, bench::CORPUS_SIZE - 1, 1)});
+
+}  // namespace
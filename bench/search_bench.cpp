@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "corpus.hpp"
+#include "search.hpp"
+
+namespace {
+
+// Shallow enough for the slowest corpus position to take a few milliseconds
+constexpr uint8_t SEARCH_DEPTH = 4;
+
+void BM_Search(benchmark::State& state) {
+  const chess::Board board = bench::LoadPosition(state.range(0));
+  state.SetLabel(bench::CORPUS[state.range(0)].name);
+  chess::Search search;
+
+  uint64_t nodes = 0;
+  for (auto _ : state) {
+    // Every iteration starts cold, not from the results of the previous one
+    state.PauseTiming();
+    search.ClearHash();
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(search.Run(board, {SEARCH_DEPTH, 0}));
+    nodes += search.GetNodes();
+  }
+  state.counters["nodes"] = static_cast<double>(search.GetNodes());
+  state.SetItemsProcessed(static_cast<int64_t>(nodes));
+}
+BENCHMARK(BM_Search)
+    ->DenseRange(0, bench::CORPUS_SIZE - 1)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_SearchThreads(benchmark::State& state) {
+  // Kiwipete, the busiest corpus position
+  const chess::Board board = bench::LoadPosition(1);
+  chess::Search search;
+  search.SetNumThreads(state.range(0));
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    search.ClearHash();
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(search.Run(board, {SEARCH_DEPTH + 1, 0}));
+  }
+}
+BENCHMARK(BM_SearchThreads)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <benchmark/benchmark.h>
+
+#include "corpus.hpp"
+#include "uciengine.hpp"
+
+/**
+ * @brief Access to the private parser of UCIEngine.
+ */
+class UCIEngineBench {
+ public:
+  static void ParseText(UCIEngine& engine, const QString& text) {
+    engine.ParseText(text);
+  }
+};
+
+namespace {
+
+void BM_ParseText(benchmark::State& state) {
+  UCIEngine engine;
+  engine.SetNumLines(3);
+  const QString text = QString{bench::RECORDED_ENGINE_OUTPUT};
+
+  for (auto _ : state) {
+    UCIEngineBench::ParseText(engine, text);
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_ParseText);
+
+}  // namespace
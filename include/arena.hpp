@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_ARENA_HPP_
+#define _CHESS_INCLUDE_ARENA_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace chess {
+
+/**
+ * @brief Fixed capacity storage that places objects one after another in a
+ * single allocation.
+ *
+ * Objects are never destroyed one by one: Reset drops all of them at once in
+ * constant time, so only trivially destructible types can be stored. Objects
+ * are addressed by their index, which stays valid until the next Reset.
+ */
+template <typename T>
+class Arena {
+  static_assert(std::is_trivially_destructible_v<T>,
+                "Arena objects are dropped without being destroyed");
+
+ public:
+  explicit Arena(std::size_t capacity)
+      : m_data(std::allocator<T>().allocate(capacity)),
+        m_capacity(capacity) {}
+
+  ~Arena() { std::allocator<T>().deallocate(m_data, m_capacity); }
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /**
+   * @brief Construct an object after the last one.
+   *
+   * @return The new object, or nullptr if the arena is full.
+   */
+  template <typename... Args>
+  T* Emplace(Args&&... args) {
+    if (m_size == m_capacity) {
+      return nullptr;
+    }
+    return std::construct_at(m_data + m_size++, std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Drop every object. The memory is kept for reuse.
+   */
+  void Reset() { m_size = 0; }
+
+  [[nodiscard]] std::size_t Size() const { return m_size; }
+  [[nodiscard]] std::size_t Capacity() const { return m_capacity; }
+  [[nodiscard]] bool IsEmpty() const { return m_size == 0; }
+  [[nodiscard]] bool IsFull() const { return m_size == m_capacity; }
+
+  [[nodiscard]] T& operator[](std::size_t i) { return m_data[i]; }
+  [[nodiscard]] const T& operator[](std::size_t i) const { return m_data[i]; }
+
+  [[nodiscard]] T* begin() { return m_data; }
+  [[nodiscard]] T* end() { return m_data + m_size; }
+  [[nodiscard]] const T* begin() const { return m_data; }
+  [[nodiscard]] const T* end() const { return m_data + m_size; }
+
+ private:
+  T* m_data;
+  std::size_t m_capacity;
+  std::size_t m_size = 0;
+};
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_ARENA_HPP_
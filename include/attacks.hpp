@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_ATTACKS_HPP_
+#define _CHESS_INCLUDE_ATTACKS_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include "bitboard.hpp"
+#include "chess.hpp"
+
+namespace chess {
+
+/**
+ * @brief A (file, rank) step of a leaping piece.
+ */
+struct Offset {
+  int8_t file;
+  int8_t rank;
+};
+
+/**
+ * @brief Build a table with the squares reached from every square of the
+ * board by a list of single steps. Steps that leave the board are dropped.
+ */
+template <std::size_t N>
+constexpr std::array<Bitboard, NUM_SQUARES> MakeLeaperAttacks(
+    const std::array<Offset, N>& offsets) {
+  std::array<Bitboard, NUM_SQUARES> table{};
+
+  for (uint8_t index = 0; index < NUM_SQUARES; ++index) {
+    const Square square = IndexToSquare(index);
+    for (const Offset& offset : offsets) {
+      const int file = square.file + offset.file;
+      const int rank = square.rank + offset.rank;
+      if ((file >= 0) && (file < 8) && (rank >= 0) && (rank < 8)) {
+        table[index] |= SquareBit(SquareIndex(static_cast<uint8_t>(file),
+                                              static_cast<uint8_t>(rank)));
+      }
+    }
+  }
+
+  return table;
+}
+
+constexpr std::array<Offset, 8> KNIGHT_OFFSETS{
+    {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}}};
+
+constexpr std::array<Offset, 8> KING_OFFSETS{
+    {{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}}};
+
+constexpr std::array<Offset, 2> WHITE_PAWN_CAPTURE_OFFSETS{{{-1, 1}, {1, 1}}};
+constexpr std::array<Offset, 2> BLACK_PAWN_CAPTURE_OFFSETS{
+    {{-1, -1}, {1, -1}}};
+
+/** Squares attacked by a knight standing on each square. */
+constexpr std::array<Bitboard, NUM_SQUARES> KNIGHT_ATTACKS =
+    MakeLeaperAttacks(KNIGHT_OFFSETS);
+
+/** Squares attacked by a king standing on each square. */
+constexpr std::array<Bitboard, NUM_SQUARES> KING_ATTACKS =
+    MakeLeaperAttacks(KING_OFFSETS);
+
+/**
+ * @brief Squares attacked by a pawn of each colour standing on each square,
+ * indexed as PAWN_ATTACKS[colour][square].
+ */
+constexpr std::array<std::array<Bitboard, NUM_SQUARES>, 2> PAWN_ATTACKS{
+    MakeLeaperAttacks(WHITE_PAWN_CAPTURE_OFFSETS),
+    MakeLeaperAttacks(BLACK_PAWN_CAPTURE_OFFSETS)};
+
+constexpr Bitboard PawnAttacks(Colour colour, uint8_t index) {
+  return PAWN_ATTACKS[static_cast<uint8_t>(colour)][index];
+}
+
+/**
+ * @brief Board constants that depend on the side, for code templated on the
+ * colour. Ranks are counted from 0 (rank 1) to 7 (rank 8).
+ */
+template <Colour C>
+struct ColourTraits {
+  static constexpr bool IS_WHITE = (C == Colour::WHITE);
+  static constexpr Colour THEM = OppositeColour(C);
+
+  /** Rank as seen from this side: rank 0 is its back rank. */
+  static constexpr uint8_t RelativeRank(uint8_t rank) {
+    return IS_WHITE ? rank : static_cast<uint8_t>(7 - rank);
+  }
+
+  static constexpr uint8_t BACK_RANK = IS_WHITE ? 0 : 7;
+  static constexpr uint8_t PAWN_START_RANK = IS_WHITE ? 1 : 6;
+  static constexpr uint8_t DOUBLE_PUSH_RANK = IS_WHITE ? 3 : 4;
+  static constexpr uint8_t PROMOTION_RANK = IS_WHITE ? 7 : 0;
+
+  /** Rank of the en passant target squares this side can capture on. */
+  static constexpr uint8_t EN_PASSANT_RANK = IS_WHITE ? 5 : 2;
+
+  static constexpr Move KING_CASTLE =
+      IS_WHITE ? WHITE_KING_CASTLE : BLACK_KING_CASTLE;
+  static constexpr Move QUEEN_CASTLE =
+      IS_WHITE ? WHITE_QUEEN_CASTLE : BLACK_QUEEN_CASTLE;
+  static constexpr Move KING_ROOK_CASTLE =
+      IS_WHITE ? WHITE_KING_ROOK_CASTLE : BLACK_KING_ROOK_CASTLE;
+  static constexpr Move QUEEN_ROOK_CASTLE =
+      IS_WHITE ? WHITE_QUEEN_ROOK_CASTLE : BLACK_QUEEN_ROOK_CASTLE;
+};
+
+/**
+ * @brief Move a set of pawns of a colour one rank forward.
+ */
+template <Colour C>
+constexpr Bitboard PawnPush(Bitboard pawns) {
+  if constexpr (C == Colour::WHITE) {
+    return pawns << 8;
+  } else {
+    return pawns >> 8;
+  }
+}
+
+/**
+ * @brief Build a table with the squares strictly between every pair of squares
+ * that share a rank, file or diagonal. Other pairs have no squares between.
+ */
+constexpr std::array<std::array<Bitboard, NUM_SQUARES>, NUM_SQUARES>
+MakeBetweenSquares() {
+  std::array<std::array<Bitboard, NUM_SQUARES>, NUM_SQUARES> table{};
+
+  for (uint8_t index = 0; index < NUM_SQUARES; ++index) {
+    const Square square = IndexToSquare(index);
+    for (const Offset& direction : KING_OFFSETS) {
+      Bitboard between = EMPTY_BITBOARD;
+      int file = square.file + direction.file;
+      int rank = square.rank + direction.rank;
+      while ((file >= 0) && (file < 8) && (rank >= 0) && (rank < 8)) {
+        const uint8_t other = SquareIndex(static_cast<uint8_t>(file),
+                                          static_cast<uint8_t>(rank));
+        table[index][other] = between;
+        between |= SquareBit(other);
+        file += direction.file;
+        rank += direction.rank;
+      }
+    }
+  }
+
+  return table;
+}
+
+/** Squares between two aligned squares, indexed as BETWEEN_SQUARES[a][b]. */
+inline constexpr std::array<std::array<Bitboard, NUM_SQUARES>, NUM_SQUARES>
+    BETWEEN_SQUARES = MakeBetweenSquares();
+
+static_assert(KNIGHT_ATTACKS[0] == 0x0000000000020400ULL);
+static_assert(KING_ATTACKS[63] == 0x40C0000000000000ULL);
+static_assert(PAWN_ATTACKS[0][12] == 0x0000000000280000ULL);
+static_assert(BETWEEN_SQUARES[0][63] == 0x0040201008040200ULL);
+static_assert(BETWEEN_SQUARES[0][10] == EMPTY_BITBOARD);
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_ATTACKS_HPP_
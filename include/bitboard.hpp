@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_BITBOARD_HPP_
+#define _CHESS_INCLUDE_BITBOARD_HPP_
+
+#include <bit>
+#include <cstdint>
+
+#include "chess.hpp"
+
+namespace chess {
+
+/**
+ * @brief A set of squares. Bit n corresponds to the square with index n, where
+ * a1 = 0, b1 = 1, ..., h1 = 7, a2 = 8, ..., h8 = 63.
+ */
+using Bitboard = uint64_t;
+
+constexpr uint8_t NUM_SQUARES = 64;
+
+constexpr Bitboard EMPTY_BITBOARD = 0ULL;
+constexpr Bitboard FILE_A_BITBOARD = 0x0101010101010101ULL;
+constexpr Bitboard RANK_1_BITBOARD = 0x00000000000000FFULL;
+
+/**
+ * @brief Index 0-63 of a square.
+ */
+constexpr uint8_t SquareIndex(uint8_t file, uint8_t rank) {
+  return static_cast<uint8_t>((rank << 3) | file);
+}
+
+constexpr uint8_t SquareIndex(const Square& square) {
+  return SquareIndex(square.file, square.rank);
+}
+
+/**
+ * @brief Square from an index 0-63.
+ */
+constexpr Square IndexToSquare(uint8_t index) {
+  return Square{static_cast<uint8_t>(index & 7U),
+                static_cast<uint8_t>(index >> 3U)};
+}
+
+constexpr Bitboard SquareBit(uint8_t index) { return Bitboard{1} << index; }
+
+constexpr Bitboard FileBitboard(uint8_t file) {
+  return FILE_A_BITBOARD << file;
+}
+
+constexpr Bitboard RankBitboard(uint8_t rank) {
+  return RANK_1_BITBOARD << (8 * rank);
+}
+
+constexpr uint8_t PopCount(Bitboard bb) {
+  return static_cast<uint8_t>(std::popcount(bb));
+}
+
+/**
+ * @brief Index of the least significant square in a non-empty set.
+ */
+constexpr uint8_t Lsb(Bitboard bb) {
+  return static_cast<uint8_t>(std::countr_zero(bb));
+}
+
+/**
+ * @brief Remove the least significant square from a non-empty set and return
+ * its index.
+ */
+constexpr uint8_t PopLsb(Bitboard& bb) {
+  const uint8_t index = Lsb(bb);
+  bb &= bb - 1;
+  return index;
+}
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_BITBOARD_HPP_
@@ -18,41 +18,367 @@
 #ifndef _CHESS_INCLUDE_BOARD_H_
 #define _CHESS_INCLUDE_BOARD_H_
 
+#include <array>
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
-#include <vector>
+#include <string_view>
 
 #include "chess.hpp"
+#include "movelist.hpp"
+#include "packedmove.hpp"
 #include "piece.hpp"
+#include "position.hpp"
+#include "zobrist.hpp"
 
 namespace chess {
 
 class Piece;
 
+/**
+ * @brief Reason why a FEN string could not be parsed.
+ */
+enum class FenError : uint8_t {
+  NONE,
+  INVALID_PIECE,
+  INVALID_RANK_LENGTH,
+  INVALID_RANK_COUNT,
+  INVALID_KING_COUNT,
+  TOO_MANY_PIECES,
+  TOO_MANY_PAWNS,
+  PAWN_ON_BACK_RANK,
+  MISSING_FIELD,
+  INVALID_SIDE_TO_MOVE,
+  INVALID_CASTLING,
+  INVALID_EN_PASSANT,
+  INVALID_HALFMOVE_CLOCK,
+  INVALID_FULLMOVE_NUMBER,
+  TRAILING_CHARACTERS
+};
+
+/**
+ * @brief Human readable description of a FEN error.
+ */
+[[nodiscard]] const char* FenErrorToString(FenError error);
+
+/**
+ * @brief Subset of the legal moves to generate.
+ */
+enum class MoveGenType : uint8_t {
+  ALL,
+  /** Captures, en passant and promotions. */
+  NOISY,
+  /** Every other move, castling included. */
+  QUIET
+};
+
+/**
+ * @brief Moves played on a board: the state needed to take them back and the
+ * keys of the positions before them, to detect repetitions. It is kept apart
+ * from the board, by whoever plays the moves, so that copying a board does
+ * not copy it.
+ */
+class BoardHistory {
+ public:
+  /** Maximum number of moves that can be made without being unmade. */
+  static constexpr std::size_t MAX_UNDO_DEPTH = 128;
+
+  /**
+   * Number of past position keys kept. A position can only repeat within
+   * the last 100 plies, since any older one is cut off by the fifty-move
+   * rule. Must be a power of two.
+   */
+  static constexpr std::size_t HISTORY_SIZE = 128;
+
+  /**
+   * @brief Number of moves pending to be unmade.
+   */
+  [[nodiscard]] std::size_t GetUndoDepth() const { return m_undo_size; }
+
+  /**
+   * @brief Forget every move, e.g. when the board is set up again.
+   */
+  void Clear() {
+    m_undo_size = 0;
+    m_num_keys = 0;
+  }
+
+ private:
+  friend class Board;
+
+  /**
+   * @brief State lost when a move is made. Restored by UnmakeMove.
+   */
+  struct UndoInfo {
+    Move move;
+    std::optional<PieceType> captured;
+    Square captured_square;
+    bool is_promotion;
+    std::optional<Square> en_passant;
+    Colour side_to_move;
+    std::optional<Square> white_king_square;
+    std::optional<Square> black_king_square;
+    bool wkc;
+    bool wqc;
+    bool bkc;
+    bool bqc;
+    uint16_t halfmove_clock;
+    uint16_t fullmove_number;
+    uint64_t hash;
+  };
+
+  std::array<UndoInfo, MAX_UNDO_DEPTH> m_undo_stack;
+  std::size_t m_undo_size = 0;
+
+  // Keys of the positions before each move played, in a ring indexed by the
+  // number of moves played modulo HISTORY_SIZE.
+  std::array<uint64_t, HISTORY_SIZE> m_keys;
+  std::size_t m_num_keys = 0;
+};
+
+struct FenResult {
+  FenError error = FenError::NONE;
+  /** Offset of the character where parsing failed. */
+  std::size_t offset = 0;
+
+  [[nodiscard]] bool IsOk() const { return error == FenError::NONE; }
+};
+
 class Board {
  public:
+  /**
+   * @brief Attack information of a position, computed on demand.
+   */
+  struct AttackMap {
+    /** Squares attacked by each colour, indexed by colour. */
+    std::array<Bitboard, 2> attacked;
+    /** Pieces giving check to the side to move. */
+    Bitboard checkers;
+    /** Pieces of the side to move pinned to their king. */
+    Bitboard pinned;
+  };
+
+  /**
+   * Longest FEN written by WriteFEN: 32 pieces with an empty square after
+   * each, 7 separators, castling, en passant and two 5-digit counters.
+   */
+  static constexpr std::size_t MAX_FEN_LENGTH = 93;
+
+  /** Buffer for a FEN string and its terminating null. */
+  using FenBuffer = std::array<char, MAX_FEN_LENGTH + 1>;
+
+  /**
+   * @brief State of a position, without the attack map cached by a board,
+   * for keeping many positions, e.g. in an Arena.
+   */
+  struct Snapshot {
+    Position position;
+    uint64_t hash;
+    std::optional<Square> en_passant;
+    std::optional<Square> white_king_square;
+    std::optional<Square> black_king_square;
+    Colour side_to_move;
+    bool wkc;
+    bool wqc;
+    bool bkc;
+    bool bqc;
+    uint16_t halfmove_clock;
+    uint16_t fullmove_number;
+  };
+
   Board() = default;
-  Board(const Board& b);
+
+  /**
+   * @brief Set up a board from a snapshot, with no moves to unmake.
+   */
+  explicit Board(const Snapshot& snapshot);
+
+  [[nodiscard]] Snapshot GetSnapshot() const;
+
+  /**
+   * @brief Set up the board from a snapshot. Moves made before are
+   * forgotten, so a BoardHistory holding them must be cleared too.
+   */
+  void SetSnapshot(const Snapshot& snapshot);
 
   [[nodiscard]] const Piece* PieceAt(uint8_t i, uint8_t j) const;
   [[nodiscard]] const Piece* PieceAt(const chess::Square& square) const;
 
+  /**
+   * @brief Piece in a square by value, or an empty code. Prefer this over
+   * PieceAt, which is kept for callers that work with Piece objects.
+   */
+  [[nodiscard]] PieceCode GetPiece(const chess::Square& square) const;
+
   void ClearPieceAt(uint8_t i, uint8_t j);
   void ClearPieceAt(const chess::Square& square);
   void Clear();
 
   void SetPiece(std::unique_ptr<Piece> piece, uint8_t i, uint8_t j);
   void SetPiece(std::unique_ptr<Piece> piece, const chess::Square& square);
+  void SetPiece(PieceType type, Colour colour, const chess::Square& square);
 
+  /**
+   * @brief Play a move without saving the state needed to take it back. A
+   * move from an empty square is ignored.
+   */
   void DoMove(const Move& move);
 
+  /**
+   * @brief Play a move that will not be taken back, e.g. a move of a game,
+   * keeping the key of the position before it to detect repetitions.
+   */
+  void DoMove(const Move& move, BoardHistory& history);
+
+  /**
+   * @brief Play a move in place, saving the state needed to take it back.
+   *
+   * @param move Move to play, of a piece on the board.
+   * @param history Where the state is saved. At most
+   * BoardHistory::MAX_UNDO_DEPTH moves can be pending to be unmade in it.
+   */
+  void MakeMove(const Move& move, BoardHistory& history);
+
+  /**
+   * @brief Take back the last move played with MakeMove.
+   *
+   * @param history History the move was saved in. There must be one pending.
+   */
+  void UnmakeMove(BoardHistory& history);
+
+  /**
+   * @brief FEN of the position without the move counters.
+   *
+   * @param active_colour Colour written as the side to move.
+   */
   [[nodiscard]] std::string GetPosition(const Colour& active_colour) const;
 
+  /**
+   * @brief Complete FEN of the position.
+   */
+  [[nodiscard]] std::string GetFEN() const;
+
+  /**
+   * @brief Write the complete FEN of the position, null terminated, into a
+   * buffer. Nothing is allocated.
+   *
+   * @return Length of the FEN, without the terminating null.
+   */
+  std::size_t WriteFEN(FenBuffer& buffer) const;
+
+  /**
+   * @brief Set up the board from a FEN string, in a single pass and without
+   * allocating. The move counters are optional and default to 0 and 1. Moves
+   * made before are forgotten, so a BoardHistory holding them must be cleared
+   * too.
+   *
+   * @param fen Position in Forsyth-Edwards Notation.
+   * @return The error and where it was found, if the string is not a valid
+   * FEN. The board is then left empty.
+   */
+  FenResult FromFEN(std::string_view fen);
+
+  /**
+   * @brief Set up the board from a FEN string.
+   *
+   * @return false The string is not a valid FEN. The board is left empty.
+   */
+  bool SetPosition(std::string_view fen);
+
+  /**
+   * @brief Half moves since the last capture or pawn move.
+   */
+  [[nodiscard]] uint16_t GetHalfmoveClock() const;
+
+  /**
+   * @brief Number of the current move, starting at 1 and incremented after
+   * each black move.
+   */
+  [[nodiscard]] uint16_t GetFullmoveNumber() const;
+
+  /**
+   * @brief Number of times the current position occurred before, counting
+   * only positions since the last capture or pawn move, which cannot
+   * repeat.
+   *
+   * @param history Moves played on the board. Positions from before the
+   * board was set up, or played with the DoMove that keeps no history, are
+   * not known.
+   */
+  [[nodiscard]] uint8_t CountRepetitions(const BoardHistory& history) const;
+
+  /**
+   * @brief The current position occurred at least twice before.
+   */
+  [[nodiscard]] bool IsThreefoldRepetition(const BoardHistory& history) const {
+    return CountRepetitions(history) >= 2;
+  }
+
+  /**
+   * @brief Fifty moves by each side were played without a capture or a pawn
+   * move. A checkmate given on the last move still takes precedence.
+   */
+  [[nodiscard]] bool IsFiftyMoveRule() const {
+    return m_halfmove_clock >= 100;
+  }
+
   void SetCastling(bool wkc, bool wqc, bool bkc, bool bqc);
 
-  [[nodiscard]] std::vector<Move> GetMovesFrom(uint8_t i, uint8_t j) const;
-  [[nodiscard]] std::vector<Move> GetMovesFrom(const Square& square) const;
+  void GetMovesFrom(uint8_t i, uint8_t j, MoveList& moves) const;
+  void GetMovesFrom(const Square& square, MoveList& moves) const;
+
+  /**
+   * @brief Append the moves of every piece of the side to move. The moves
+   * follow the piece movement rules but may leave the king in check.
+   *
+   * @param moves List to append the moves to.
+   */
+  void GenerateMoves(MoveList& moves) const;
+
+  /**
+   * @brief GenerateMoves for a side to move known at compile time.
+   *
+   * @tparam Us Side to move.
+   */
+  template <Colour Us>
+  void GenerateMoves(MoveList& moves) const;
+
+  /**
+   * @brief Append the legal moves of the side to move. Checkers and pinned
+   * pieces are computed once, so no move has to be tried on the board.
+   *
+   * @param moves List to append the moves to.
+   * @param type Subset of the moves. The noisy and the quiet moves together
+   * are all the legal moves, so a search can generate the quiet moves only if
+   * the noisy ones do not cut it off.
+   */
+  void GenerateLegalMoves(MoveList& moves,
+                          MoveGenType type = MoveGenType::ALL) const;
+
+  /**
+   * @brief GenerateLegalMoves for a side to move and subset known at compile
+   * time.
+   *
+   * @tparam Us Side to move.
+   * @tparam Type Subset of the moves.
+   */
+  template <Colour Us, MoveGenType Type = MoveGenType::ALL>
+  void GenerateLegalMoves(MoveList& moves) const;
+
+  /**
+   * @brief A move of this position is a capture, an en passant capture or a
+   * promotion.
+   */
+  [[nodiscard]] bool IsNoisyMove(const Move& move) const;
+
+  /**
+   * @brief Pack a move of this position, flagging castling and en passant.
+   */
+  [[nodiscard]] PackedMove PackMove(const Move& move) const;
+
+  [[nodiscard]] Colour GetSideToMove() const;
+  void SetSideToMove(Colour colour);
 
   [[nodiscard]] bool IsValidMove(const Move& move, Colour active_colour) const;
 
@@ -79,15 +405,98 @@ class Board {
    */
   [[nodiscard]] bool CanBeCaptured(const Square& square) const;
 
+  /**
+   * @brief Static exchange evaluation: material won by the side making a
+   * move if both sides then keep capturing on its destination square with
+   * their least valuable piece, each stopping when that would lose material.
+   * Pins are not considered.
+   *
+   * @param move A move of a piece on the board, usually a capture.
+   * @return The balance in the units of PAWN_VALUE to QUEEN_VALUE, negative
+   * if the moved piece is lost for less. A move onto a square where the piece
+   * hangs scores minus its value.
+   */
+  [[nodiscard]] int SEE(const Move& move) const;
+
+  /**
+   * @brief Check if a square is attacked by a colour. The square does not
+   * need to be occupied.
+   *
+   * @param square Square to check
+   * @param by Colour of the attacking pieces
+   * @return true Some piece of the given colour attacks the square.
+   */
+  [[nodiscard]] bool IsSquareAttacked(const Square& square, Colour by) const;
+
+  /**
+   * @brief Pieces of both colours attacking a square.
+   */
+  [[nodiscard]] Bitboard AttackersOf(const Square& square) const;
+
+  /**
+   * @brief Attack map of the position. It is computed on the first call and
+   * kept until the board changes, so the attack queries of a position share
+   * one computation. Move generation, move validation and check detection
+   * test single squares instead. Not safe to call from several threads on
+   * the same board.
+   */
+  [[nodiscard]] const AttackMap& GetAttackMap() const;
+
   [[nodiscard]] Board AfterMove(const Move& move) const;
 
   const std::optional<Square>& GetWhiteKing() const;
   const std::optional<Square>& GetBlackKing() const;
 
+  /**
+   * @brief Square a pawn can move to by capturing en passant.
+   */
+  const std::optional<Square>& GetEnPassant() const;
+
+  /**
+   * @brief Bitboard representation of the piece placement.
+   */
+  [[nodiscard]] const Position& GetBitboards() const;
+
+  /**
+   * @brief Number of pieces of a colour and type on the board.
+   */
+  [[nodiscard]] uint8_t GetPieceCount(Colour colour, PieceType type) const {
+    return m_position.GetCount(colour, type);
+  }
+
+  /**
+   * @brief Sum of the values of the pieces of a colour, the king excluded.
+   * Updated incrementally.
+   */
+  [[nodiscard]] uint16_t GetMaterial(Colour colour) const {
+    return m_position.GetMaterial(colour);
+  }
+
+  /**
+   * @brief Sum of the piece-square bonuses of a colour, in centipawns.
+   * Updated incrementally.
+   */
+  [[nodiscard]] int16_t GetPsqScore(Colour colour) const {
+    return m_position.GetPsqScore(colour);
+  }
+
+  /**
+   * @brief Zobrist key of the position: piece placement, side to move,
+   * castling rights and en passant file. Updated incrementally.
+   */
+  [[nodiscard]] uint64_t Hash() const { return m_hash; }
+
+  /**
+   * @brief Zobrist key computed from scratch. Always equal to Hash(); meant
+   * for checking the incremental updates.
+   */
+  [[nodiscard]] uint64_t ComputeHash() const;
+
  private:
-  std::unique_ptr<Piece> m_board[8][8];
+  Position m_position;
 
   std::optional<Square> m_en_passant;
+  Colour m_side_to_move = Colour::WHITE;
   std::optional<Square> m_white_king_square;
   std::optional<Square> m_black_king_square;
 
@@ -96,11 +505,77 @@ class Board {
   bool m_bkc = true;
   bool m_bqc = true;
 
+  uint16_t m_halfmove_clock = 0;
+  uint16_t m_fullmove_number = 1;
+
+  uint64_t m_hash = CastlingKey(true, true, true, true);
+
+  mutable AttackMap m_attack_map;
+  mutable bool m_attack_map_valid = false;
+
+  /**
+   * @brief Pieces of both colours attacking a square, given the occupied
+   * squares.
+   */
+  [[nodiscard]] Bitboard AttackersTo(uint8_t index, Bitboard occupied) const;
+
+  std::size_t WriteFEN(char* buffer, Colour active_colour,
+                       bool with_counters) const;
+
+  /**
+   * @brief A square is attacked by a colour, given the occupied squares.
+   */
+  template <Colour By>
+  [[nodiscard]] bool IsAttackedBy(uint8_t index, Bitboard occupied) const;
+
+  /**
+   * @brief Squares attacked by a colour, given the occupied squares.
+   */
+  template <Colour By>
+  [[nodiscard]] Bitboard AttackedSquares(Bitboard occupied) const;
+
+  /**
+   * @brief Pieces of a colour pinned to their king on a square. The line
+   * each pinned piece can move along is stored in pin_rays.
+   */
+  template <Colour Us>
+  [[nodiscard]] Bitboard PinnedPieces(
+      uint8_t king_index, Bitboard occupied,
+      std::array<Bitboard, NUM_SQUARES>& pin_rays) const;
+
+  template <Colour Us>
+  void ComputeAttackMap() const;
+
+  /**
+   * @brief A move of a piece of the side to move, already known to follow
+   * the piece movement rules, does not leave its king in check.
+   */
+  [[nodiscard]] bool IsLegalPseudoLegalMove(const Move& move) const;
+
+  /**
+   * @brief The castling right is held and the king and rook stand on their
+   * squares with nothing between them. Attacks are not considered.
+   */
+  template <Colour C, bool KING_SIDE>
+  [[nodiscard]] bool HasCastlingPath() const;
+
+  template <Colour C, bool KING_SIDE>
+  [[nodiscard]] bool CanCastle() const;
+  template <Colour Us>
+  void GenerateCastles(MoveList& moves) const;
+
+  /**
+   * @brief DoMove for a moving piece of a colour known at compile time.
+   */
+  template <Colour Us>
+  void DoMove(const Move& move);
+
   void MovePieces(const Move& move);
   void MoveForPromotion(const Move& move);
 
-  void SaveSquareIfKing(Piece* const piece);
-  void UpdateCastles();
+  void SaveSquareIfKing(const Square& square);
+  void UpdateCastles(const Move& move);
+  void SetEnPassant(const std::optional<Square>& en_passant);
 
   [[nodiscard]] bool MoveIsWKC(const Move& move) const;
   [[nodiscard]] bool MoveIsWQC(const Move& move) const;
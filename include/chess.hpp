@@ -140,6 +140,13 @@ char NumberToFile(uint8_t number);
  */
 void ToggleColour(Colour* colour);
 
+/**
+ * @brief The colour of the other player.
+ */
+constexpr Colour OppositeColour(Colour colour) {
+  return (colour == Colour::WHITE) ? Colour::BLACK : Colour::WHITE;
+}
+
 /**
  * @brief Returns true if the given square is contained in the 8x8 chess board.
  */
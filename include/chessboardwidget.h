@@ -34,7 +34,13 @@ class ChessBoardWidget : public QWidget {
 
   void Reset();
 
-  void SetPosition(const QString& fen_str);
+  /**
+   * @brief Set the position to show.
+   *
+   * @param fen_str Position in Forsyth-Edwards Notation.
+   * @return false The string is not a valid FEN. The position is unchanged.
+   */
+  bool SetPosition(const QString& fen_str);
 
   void Rotate();
   void SetSide(chess::Colour side);
@@ -151,6 +157,13 @@ class ChessBoardWidget : public QWidget {
   chess::Square GetClickedSquare(int x, int y) const;
   bool IsOnBoard(int x, int y) const;
 
+  /**
+   * @brief Ask the user which piece to promote a pawn to.
+   *
+   * @return The chosen piece type, or nothing if the user cancelled.
+   */
+  std::optional<chess::PieceType> AskPromotionType();
+
   float GetBalance() const;
   float Transform(float x) const;
 };
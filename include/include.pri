@@ -1,12 +1,31 @@
-HEADERS += \
-  $$PWD/resources.hpp \
+CORE_HEADERS = \
   $$PWD/chess.hpp \
+  $$PWD/bitboard.hpp \
+  $$PWD/piececode.hpp \
+  $$PWD/psqt.hpp \
+  $$PWD/position.hpp \
+  $$PWD/attacks.hpp \
+  $$PWD/magic.hpp \
+  $$PWD/movelist.hpp \
+  $$PWD/movepicker.hpp \
+  $$PWD/arena.hpp \
+  $$PWD/packedmove.hpp \
+  $$PWD/zobrist.hpp \
   $$PWD/piece.hpp \
   $$PWD/board.hpp \
+  $$PWD/threadpool.hpp \
+  $$PWD/perft.hpp \
+  $$PWD/transpositiontable.hpp \
+  $$PWD/search.hpp
+
+HEADERS += \
+  $$PWD/resources.hpp \
+  $$CORE_HEADERS \
   $$PWD/chessboardwidget.h \
   $$PWD/mainwindow.hpp \
   $$PWD/settingsdialog.h \
   $$PWD/uciengine.hpp \
+  $$PWD/nativeengine.hpp \
   $$PWD/player.hpp
 
 INCLUDEPATH += $$PWD
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_MAGIC_HPP_
+#define _CHESS_INCLUDE_MAGIC_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "bitboard.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CHESS_PEXT_AVAILABLE 1
+#include <immintrin.h>
+#endif
+
+namespace chess {
+
+/**
+ * @brief Build the sliding attack tables. They are built once at start-up,
+ * so this only needs to be called to change the lookup method.
+ *
+ * @param allow_pext Use the BMI2 PEXT instruction for lookups if the CPU
+ * supports it. On CPUs where PEXT is microcoded, magic multiplication is
+ * faster.
+ */
+void InitSlidingAttacks(bool allow_pext = true);
+
+/**
+ * @brief True if the sliding attack lookups use PEXT instead of magic
+ * multiplication.
+ */
+[[nodiscard]] bool IsUsingPext();
+
+namespace magic {
+
+/**
+ * @brief Lookup data of a slider on a square. The relevant occupancy bits
+ * (the rays without the board edges) are mapped to a perfect hash index into a
+ * table of precomputed attack sets.
+ */
+struct Magic {
+  Bitboard mask;
+  Bitboard magic;
+  const Bitboard* attacks;
+  uint8_t shift;
+};
+
+extern std::array<Magic, NUM_SQUARES> rook_magics;
+extern std::array<Magic, NUM_SQUARES> bishop_magics;
+extern bool use_pext;
+
+#ifdef CHESS_PEXT_AVAILABLE
+__attribute__((target("bmi2"))) inline uint64_t Pext(uint64_t value,
+                                                     uint64_t mask) {
+  return _pext_u64(value, mask);
+}
+#endif
+
+inline std::size_t Index(const Magic& entry, Bitboard occupied) {
+#ifdef CHESS_PEXT_AVAILABLE
+  if (use_pext) {
+    return Pext(occupied, entry.mask);
+  }
+#endif
+  return ((occupied & entry.mask) * entry.magic) >> entry.shift;
+}
+
+inline Bitboard Lookup(const Magic& entry, Bitboard occupied) {
+  return entry.attacks[Index(entry, occupied)];
+}
+
+}  // namespace magic
+
+/**
+ * @brief Squares attacked by a rook on a square, given the occupied squares.
+ * The set includes the first blocker in each direction.
+ */
+inline Bitboard RookAttacks(uint8_t index, Bitboard occupied) {
+  return magic::Lookup(magic::rook_magics[index], occupied);
+}
+
+/**
+ * @brief Squares attacked by a bishop on a square, given the occupied
+ * squares. The set includes the first blocker in each direction.
+ */
+inline Bitboard BishopAttacks(uint8_t index, Bitboard occupied) {
+  return magic::Lookup(magic::bishop_magics[index], occupied);
+}
+
+/**
+ * @brief Squares attacked by a queen on a square, given the occupied squares.
+ */
+inline Bitboard QueenAttacks(uint8_t index, Bitboard occupied) {
+  return RookAttacks(index, occupied) | BishopAttacks(index, occupied);
+}
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_MAGIC_HPP_
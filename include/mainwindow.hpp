@@ -26,6 +26,7 @@
 #include "board.hpp"
 #include "chess.hpp"
 #include "chessboardwidget.h"
+#include "nativeengine.hpp"
 #include "player.hpp"
 #include "settingsdialog.h"
 #include "uciengine.hpp"
@@ -73,6 +74,7 @@ class MainWindow : public QMainWindow {
   void on_actionSettings_triggered();
   void on_bSettings_clicked();
   void on_actionRestart_triggered();
+  void on_actionInternal_engine_toggled(bool checked);
   void on_bDownload_clicked();
 
  private:
@@ -90,6 +92,10 @@ class MainWindow : public QMainWindow {
   UCIEngine m_engine;
   const char* DEFAULT_ENGINE_CMD = "stockfish";
 
+  /** Internal search, used instead of the external engine when enabled. */
+  NativeEngine m_native_engine;
+  bool m_use_native_engine = false;
+
   /** Engine search depth. */
   uint8_t m_depth;
 
@@ -119,6 +125,21 @@ class MainWindow : public QMainWindow {
    */
   void RestartSearch();
 
+  /**
+   * @brief Start a search of the engine in use with the current limits.
+   */
+  void StartSearch();
+
+  /**
+   * @brief Stop the search of the engine in use.
+   */
+  void StopSearch();
+
+  /**
+   * @brief Set the position of both engines.
+   */
+  void SetEnginePosition(const QString& fen_str);
+
   /** Update the move list widget*/
   void UpdateMoveList();
 
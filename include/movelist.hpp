@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_MOVELIST_HPP_
+#define _CHESS_INCLUDE_MOVELIST_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+#include "chess.hpp"
+
+namespace chess {
+
+/**
+ * @brief A list of moves with inline storage. No legal position has more than
+ * 218 moves, and Board::FromFEN rejects positions with more material than a
+ * game can reach, so move generation stays within the capacity and filling
+ * the list never allocates.
+ */
+class MoveList {
+ public:
+  static constexpr std::size_t CAPACITY = 256;
+
+  void Add(const Move& move) {
+    assert(m_size < CAPACITY);
+    m_moves[m_size++] = move;
+  }
+
+  void Clear() { m_size = 0; }
+
+  [[nodiscard]] std::size_t Size() const { return m_size; }
+  [[nodiscard]] bool IsEmpty() const { return m_size == 0; }
+
+  [[nodiscard]] bool Contains(const Move& move) const {
+    return std::find(begin(), end(), move) != end();
+  }
+
+  [[nodiscard]] Move& operator[](std::size_t i) { return m_moves[i]; }
+  [[nodiscard]] const Move& operator[](std::size_t i) const {
+    return m_moves[i];
+  }
+
+  [[nodiscard]] Move* begin() { return m_moves.data(); }
+  [[nodiscard]] Move* end() { return m_moves.data() + m_size; }
+  [[nodiscard]] const Move* begin() const { return m_moves.data(); }
+  [[nodiscard]] const Move* end() const { return m_moves.data() + m_size; }
+
+ private:
+  std::array<Move, CAPACITY> m_moves;
+  std::size_t m_size = 0;
+};
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_MOVELIST_HPP_
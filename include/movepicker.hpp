@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_MOVEPICKER_HPP_
+#define _CHESS_INCLUDE_MOVEPICKER_HPP_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "board.hpp"
+#include "movelist.hpp"
+#include "packedmove.hpp"
+
+namespace chess {
+
+/** Quiet moves that caused a cutoff at a ply, the most recent first. */
+using Killers = std::array<PackedMove, 2>;
+
+/**
+ * @brief Statistics of the quiet moves of a search: a butterfly history
+ * table, indexed by side, source and destination, scoring how often a move
+ * caused a cutoff, and the move that last refuted each previous move.
+ */
+class MoveHistory {
+ public:
+  /** History scores stay within plus and minus this value. */
+  static constexpr int MAX_SCORE = 16384;
+
+  MoveHistory() { Clear(); }
+
+  void Clear();
+
+  [[nodiscard]] int GetScore(Colour side, PackedMove move) const {
+    return m_scores[static_cast<uint8_t>(side)][move.GetSrc()][move.GetDst()];
+  }
+
+  [[nodiscard]] PackedMove GetCounterMove(PackedMove previous) const {
+    return m_counter_moves[previous.GetSrc()][previous.GetDst()];
+  }
+
+  /**
+   * @brief Reward a quiet move that caused a cutoff at a depth and make it
+   * the counter move of the previous move.
+   */
+  void AddCutoff(Colour side, PackedMove previous, PackedMove move,
+                 uint8_t depth);
+
+  /**
+   * @brief Penalise a quiet move searched before the one causing a cutoff.
+   */
+  void AddFailure(Colour side, PackedMove move, uint8_t depth);
+
+ private:
+  std::array<std::array<std::array<int16_t, NUM_SQUARES>, NUM_SQUARES>, 2>
+      m_scores;
+  std::array<std::array<PackedMove, NUM_SQUARES>, NUM_SQUARES>
+      m_counter_moves;
+
+  void Update(Colour side, PackedMove move, int bonus);
+};
+
+/**
+ * @brief Yields the legal moves of a position in the order they are most
+ * likely to cause a cutoff, generating them in stages.
+ *
+ * The hash move comes first, before anything is generated. Then the noisy
+ * moves, by most valuable victim and least valuable attacker. The quiet moves
+ * are only generated after those: killers, then the counter move, then the
+ * rest by history score. Within a stage, the best remaining move is picked
+ * each time instead of sorting, since a cutoff usually comes early.
+ *
+ * A picker for a quiescence search yields the noisy moves only.
+ */
+class MovePicker {
+ public:
+  /**
+   * @param board Position to pick moves from. It must not change while the
+   * picker is used, except for moves made and unmade between calls to Next.
+   * @param hash_move Best move of an earlier search of the position, or the
+   * null move. It is checked for legality, so a hash collision is harmless.
+   * @param killers Killer moves of the ply.
+   * @param counter_move Counter move of the previous move, or the null move.
+   * @param history History of the search.
+   */
+  MovePicker(const Board& board, PackedMove hash_move, const Killers& killers,
+             PackedMove counter_move, const MoveHistory& history);
+
+  /**
+   * @brief Pick only the noisy moves of a position, for a quiescence search.
+   */
+  explicit MovePicker(const Board& board);
+
+  /**
+   * @brief Next move to search, or nothing when every legal move was given.
+   */
+  [[nodiscard]] std::optional<Move> Next();
+
+ private:
+  enum class Stage : uint8_t {
+    HASH_MOVE,
+    GENERATE_NOISY,
+    NOISY,
+    GENERATE_QUIET,
+    QUIET,
+    DONE
+  };
+
+  const Board& m_board;
+  // Null when only noisy moves are picked
+  const Killers* m_killers = nullptr;
+  const PackedMove m_counter_move;
+  const MoveHistory* m_history = nullptr;
+  std::optional<Move> m_hash_move;
+
+  Stage m_stage = Stage::HASH_MOVE;
+  MoveList m_moves;
+  std::array<int, MoveList::CAPACITY> m_scores;
+  std::size_t m_next = 0;
+
+  void ScoreNoisyMoves();
+  void ScoreQuietMoves();
+
+  /**
+   * @brief Move the best scored of the remaining moves to the next position
+   * and return it.
+   */
+  [[nodiscard]] const Move& PickBest();
+};
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_MOVEPICKER_HPP_
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_NATIVE_ENGINE_HPP_
+#define _CHESS_INCLUDE_NATIVE_ENGINE_HPP_
+
+#include <QObject>
+#include <QString>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "board.hpp"
+#include "search.hpp"
+#include "uciengine.hpp"
+
+/**
+ * @brief Analysis with the internal search, with the same interface as
+ * UCIEngine so that the window can use either. The search runs in a thread of
+ * its own and reports a single line.
+ */
+class NativeEngine : public QObject {
+  Q_OBJECT
+
+ public:
+  NativeEngine();
+  ~NativeEngine();
+
+  /**
+   * @brief Forget the results of previous searches.
+   */
+  void NewGame();
+
+  /**
+   * @brief Set a position using FEN format. Stops the search. Nothing is
+   * searched until a valid position is set.
+   * @param fen FEN string describing the position.
+   */
+  void SetPosition(const QString& fen);
+
+  /**
+   * @brief Stop the search and wait for it to finish.
+   */
+  void Stop();
+
+  /**
+   * @brief Search using a maximum depth.
+   * @param depth Maximum depth.
+   */
+  void SearchWithDepth(uint8_t depth);
+
+  /**
+   * @brief Search until stopped, or until the deepest depth is reached.
+   */
+  void SearchInfinite();
+
+  /**
+   * @brief Set number of threads. Stops the search.
+   * @param num_threads Number of CPU threads to use.
+   */
+  void SetNumThreads(uint16_t num_threads);
+
+  /**
+   * @brief Get a copy of the line of the last completed depth.
+   */
+  std::vector<UCIEngine::DepthInfo> GetLines();
+
+ signals:
+  void DepthInfoAvailable();
+
+ private:
+  chess::Search m_search;
+  chess::Board m_board;
+  bool m_has_position = false;
+  std::thread m_search_thread;
+
+  std::vector<UCIEngine::DepthInfo> m_lines;
+  std::mutex m_info_mutex;
+
+  void StartSearch(const chess::SearchLimits& limits);
+  void OnSearchInfo(const chess::SearchInfo& info);
+};
+
+#endif  // _CHESS_INCLUDE_NATIVE_ENGINE_HPP_
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_PACKEDMOVE_HPP_
+#define _CHESS_INCLUDE_PACKEDMOVE_HPP_
+
+#include <cstdint>
+#include <string>
+
+#include "bitboard.hpp"
+#include "chess.hpp"
+
+namespace chess {
+
+/**
+ * @brief A move packed in 16 bits, for storing moves in bulk.
+ *
+ * Bits 0-5: source square index.
+ * Bits 6-11: destination square index.
+ * Bits 12-13: promotion type (knight, bishop, rook, queen).
+ * Bits 14-15: special move flag.
+ *
+ * The zero value (a1a1) is the null move.
+ */
+class PackedMove {
+ public:
+  enum class Flag : uint8_t {
+    NORMAL = 0,
+    PROMOTION = 1,
+    EN_PASSANT = 2,
+    CASTLING = 3
+  };
+
+  constexpr PackedMove() = default;
+
+  constexpr PackedMove(uint8_t src, uint8_t dst, Flag flag = Flag::NORMAL,
+                       PieceType promotion_type = PieceType::KNIGHT)
+      : m_data(static_cast<uint16_t>(
+            src | (dst << 6) |
+            ((static_cast<uint8_t>(promotion_type) -
+              static_cast<uint8_t>(PieceType::KNIGHT))
+             << 12) |
+            (static_cast<uint8_t>(flag) << 14))) {}
+
+  /**
+   * @brief Pack a move. Only the promotion flag can be derived from a Move;
+   * use Board::PackMove to also flag castling and en passant.
+   */
+  constexpr explicit PackedMove(const Move& move)
+      : PackedMove(SquareIndex(move.src), SquareIndex(move.dst),
+                   move.is_pawn_promotion ? Flag::PROMOTION : Flag::NORMAL,
+                   move.is_pawn_promotion ? move.promotion_type
+                                          : PieceType::KNIGHT) {}
+
+  [[nodiscard]] static constexpr PackedMove FromRaw(uint16_t data) {
+    PackedMove move;
+    move.m_data = data;
+    return move;
+  }
+
+  [[nodiscard]] constexpr uint16_t GetRaw() const { return m_data; }
+
+  [[nodiscard]] constexpr uint8_t GetSrc() const { return m_data & 0x3F; }
+  [[nodiscard]] constexpr uint8_t GetDst() const {
+    return (m_data >> 6) & 0x3F;
+  }
+  [[nodiscard]] constexpr Flag GetFlag() const {
+    return static_cast<Flag>(m_data >> 14);
+  }
+  [[nodiscard]] constexpr PieceType GetPromotionType() const {
+    return static_cast<PieceType>(((m_data >> 12) & 0x3) +
+                                  static_cast<uint8_t>(PieceType::KNIGHT));
+  }
+
+  [[nodiscard]] constexpr bool IsNull() const { return m_data == 0; }
+  [[nodiscard]] constexpr bool IsPromotion() const {
+    return GetFlag() == Flag::PROMOTION;
+  }
+
+  /**
+   * @brief Unpack the move. Packing the result gives back the same move,
+   * except for the castling and en passant flags, which Move does not keep.
+   */
+  [[nodiscard]] constexpr Move ToMove() const {
+    Move move{IndexToSquare(GetSrc()), IndexToSquare(GetDst())};
+    if (IsPromotion()) {
+      move.is_pawn_promotion = true;
+      move.promotion_type = GetPromotionType();
+    }
+    return move;
+  }
+
+  constexpr bool operator==(const PackedMove& other) const = default;
+
+ private:
+  uint16_t m_data = 0;
+};
+
+static_assert(sizeof(PackedMove) == 2);
+
+/**
+ * @brief Converts a packed move into a string representation
+ */
+[[nodiscard]] inline std::string MoveToUCI(PackedMove move) {
+  return MoveToUCI(move.ToMove());
+}
+
+/**
+ * @brief Converts a move string into a packed move.
+ */
+[[nodiscard]] inline PackedMove UCIToPackedMove(const std::string& uci) {
+  return PackedMove(UCIToMove(uci));
+}
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_PACKEDMOVE_HPP_
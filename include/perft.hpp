@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_PERFT_HPP_
+#define _CHESS_INCLUDE_PERFT_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "board.hpp"
+
+namespace chess {
+
+/**
+ * @brief Node counts of subtrees, shared by all perft threads without locks.
+ *
+ * Each entry is two 64-bit words written independently: the data (node count
+ * and depth) and the position key XORed with the data. An entry torn by two
+ * threads writing at once does not verify against the key and is treated as
+ * a miss.
+ */
+class PerftTable {
+ public:
+  /**
+   * @param size_mb Size of the table in MiB, rounded down to a power of two
+   * number of entries.
+   */
+  explicit PerftTable(std::size_t size_mb);
+
+  [[nodiscard]] bool Probe(uint64_t hash, uint8_t depth,
+                           uint64_t* nodes) const;
+  void Store(uint64_t hash, uint8_t depth, uint64_t nodes);
+
+ private:
+  struct Entry {
+    std::atomic<uint64_t> key{0};
+    std::atomic<uint64_t> data{0};
+  };
+
+  std::unique_ptr<Entry[]> m_entries;
+  std::size_t m_mask;
+};
+
+/**
+ * @brief Count the leaf nodes of the legal move tree of a position.
+ *
+ * @param board Position to count from. It is left unchanged.
+ * @param depth Depth of the tree, at most BoardHistory::MAX_UNDO_DEPTH.
+ * @param table Optional table to reuse the counts of transposed subtrees.
+ * @return Number of move sequences of the given length.
+ */
+[[nodiscard]] uint64_t Perft(Board& board, uint8_t depth,
+                             PerftTable* table = nullptr);
+
+/**
+ * @brief Leaf nodes below one of the moves of the root position.
+ */
+struct PerftDivideEntry {
+  Move move;
+  uint64_t nodes;
+};
+
+/**
+ * @brief Perft split by the moves of the root position, to find which move
+ * leads to a wrong count.
+ */
+[[nodiscard]] std::vector<PerftDivideEntry> PerftDivide(Board& board,
+                                                        uint8_t depth);
+
+/**
+ * @brief PerftDivide spread over several threads. The subtrees of the root
+ * moves, and of their replies when deep enough, are counted as separate tasks
+ * of a work-stealing thread pool.
+ *
+ * @param board Position to count from.
+ * @param depth Depth of the tree.
+ * @param num_threads Number of threads. Zero uses all hardware threads.
+ * @param table Optional table shared by all threads.
+ */
+[[nodiscard]] std::vector<PerftDivideEntry> ParallelPerftDivide(
+    const Board& board, uint8_t depth, std::size_t num_threads = 0,
+    PerftTable* table = nullptr);
+
+/**
+ * @brief A position with known perft results.
+ */
+struct PerftPosition {
+  const char* name;
+  const char* fen;
+  /** Node count at depths 1 to 6. */
+  std::array<uint64_t, 6> nodes;
+};
+
+/**
+ * @brief Reference positions from the Chess Programming Wiki, chosen to
+ * exercise castling, en passant, promotions and pins.
+ */
+constexpr std::array<PerftPosition, 6> PERFT_POSITIONS{{
+    {"start", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+     {20, 400, 8902, 197281, 4865609, 119060324}},
+    {"kiwipete",
+     "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+     {48, 2039, 97862, 4085603, 193690690, 8031647685}},
+    {"position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+     {14, 191, 2812, 43238, 674624, 11030083}},
+    {"position 4",
+     "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+     {6, 264, 9467, 422333, 15833292, 706045033}},
+    {"position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+     {44, 1486, 62379, 2103487, 89941194, 3048196529}},
+    {"position 6",
+     "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 "
+     "w - - 0 10",
+     {46, 2079, 89890, 3894594, 164075551, 6923051137}},
+}};
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_PERFT_HPP_
@@ -18,101 +18,110 @@
 #ifndef _CHESS_INCLUDE_PIECE_HPP_
 #define _CHESS_INCLUDE_PIECE_HPP_
 
-#include <vector>
-
+#include "bitboard.hpp"
 #include "board.hpp"
 #include "chess.hpp"
+#include "movelist.hpp"
+#include "piececode.hpp"
 
 namespace chess {
 
 class Board;
 
+/**
+ * @brief Compatibility wrapper around a PieceCode, for callers that work with
+ * piece objects. The class is not polymorphic: every piece type shares the
+ * same layout and move generation dispatches on the code.
+ */
 class Piece {
  public:
-  Piece(Colour colour, PieceType type, uint8_t value);
+  Piece(Colour colour, PieceType type);
+  explicit Piece(PieceCode code);
 
   [[nodiscard]] static std::unique_ptr<Piece> Factory(PieceType type,
                                                       Colour colour);
 
+  /**
+   * @brief Get a shared, immutable instance of a piece. Boards do not own
+   * piece objects; they hand out these instances instead.
+   */
+  [[nodiscard]] static const Piece* Get(PieceType type, Colour colour);
+
   static constexpr uint32_t FLAG_EXCLUDE_CASTLES = (1 << 0);
 
+  [[nodiscard]] PieceCode GetCode() const;
   [[nodiscard]] Colour GetColour() const;
   [[nodiscard]] PieceType GetType() const;
   [[nodiscard]] uint8_t GetValue() const;
-  [[nodiscard]] Square GetSquare() const;
-  void SetSquare(const Square& square);
-  [[nodiscard]] bool HasMoved() const;
-  void SetMoved(bool moved);
 
-  [[nodiscard]] virtual std::unique_ptr<Piece> Clone() const = 0;
+  [[nodiscard]] std::unique_ptr<Piece> Clone() const;
+
+  /**
+   * @brief Append the moves of this piece standing in a square of the board.
+   */
+  void GetMoves(const Board& board, const Square& square, MoveList& moves,
+                uint32_t flag = 0) const;
+  [[nodiscard]] char GetFenChar() const;
+
+  /**
+   * @brief Append a move from src to every square in a set of targets.
+   */
+  static void AddMoves(MoveList& moves, const Square& src, Bitboard targets);
 
-  [[nodiscard]] virtual std::vector<Move> GetMoves(const Board& board,
-                                                   uint32_t flag = 0) const = 0;
-  [[nodiscard]] virtual char GetFenChar() const = 0;
+  /**
+   * @brief Append pawn moves from src to every square in a set of targets.
+   * Moves to the last rank are added once per promotion type.
+   */
+  static void AddPawnMoves(MoveList& moves, const Square& src,
+                           Bitboard targets);
 
  protected:
-  const Colour m_colour;
-  const PieceType m_type;
-  Square m_square;
-  const uint8_t m_value;
-  bool m_has_moved = false;
-
-  [[nodiscard]] std::vector<Move> GetSlidingMoves(const Board& board,
-                                                  Direction direction) const;
+  const PieceCode m_code;
 };
 
+/**
+ * @brief Append the moves of a piece standing in a square of the board,
+ * dispatching on the piece type. The piece must not be empty.
+ */
+void GetPieceMoves(const Board& board, PieceCode piece, const Square& square,
+                   MoveList& moves, uint32_t flag = 0);
+
+/**
+ * @brief Append the moves of a piece of a colour known at compile time. Side
+ * dependent constants are resolved by the compiler.
+ */
+template <Colour C>
+void GetPieceMoves(const Board& board, PieceType type, const Square& square,
+                   MoveList& moves, uint32_t flag = 0);
+
 class Pawn final : public Piece {
  public:
   Pawn(Colour colour);
-  [[nodiscard]] std::unique_ptr<Piece> Clone() const override;
-  [[nodiscard]] char GetFenChar() const override;
-  [[nodiscard]] std::vector<Move> GetMoves(const Board& board,
-                                           uint32_t flag = 0) const override;
 };
 
 class Knight final : public Piece {
  public:
   Knight(Colour colour);
-  [[nodiscard]] std::unique_ptr<Piece> Clone() const override;
-  [[nodiscard]] char GetFenChar() const override;
-  [[nodiscard]] std::vector<Move> GetMoves(const Board& board,
-                                           uint32_t flag = 0) const override;
 };
 
 class Bishop final : public Piece {
  public:
   Bishop(Colour colour);
-  [[nodiscard]] std::unique_ptr<Piece> Clone() const override;
-  [[nodiscard]] char GetFenChar() const override;
-  [[nodiscard]] std::vector<Move> GetMoves(const Board& board,
-                                           uint32_t flag = 0) const override;
 };
 
 class Rook final : public Piece {
  public:
   Rook(Colour colour);
-  [[nodiscard]] std::unique_ptr<Piece> Clone() const override;
-  [[nodiscard]] char GetFenChar() const override;
-  [[nodiscard]] std::vector<Move> GetMoves(const Board& board,
-                                           uint32_t flag = 0) const override;
 };
 
 class Queen final : public Piece {
  public:
   Queen(Colour colour);
-  [[nodiscard]] std::unique_ptr<Piece> Clone() const override;
-  [[nodiscard]] char GetFenChar() const override;
-  [[nodiscard]] std::vector<Move> GetMoves(const Board& board,
-                                           uint32_t flag = 0) const override;
 };
 
 class King final : public Piece {
  public:
   King(Colour colour);
-  [[nodiscard]] std::unique_ptr<Piece> Clone() const override;
-  [[nodiscard]] char GetFenChar() const override;
-  [[nodiscard]] std::vector<Move> GetMoves(const Board& board,
-                                           uint32_t flag = 0) const override;
 };
 
 }  // namespace chess
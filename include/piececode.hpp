@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_PIECECODE_HPP_
+#define _CHESS_INCLUDE_PIECECODE_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include "chess.hpp"
+
+namespace chess {
+
+/**
+ * @brief A piece packed in 8 bits, for passing pieces around by value.
+ *
+ * Bits 0-2: piece type.
+ * Bit 3: colour.
+ *
+ * All other values are reserved; 0xFF is the code of an empty square.
+ */
+class PieceCode {
+ public:
+  /** Code of an empty square. */
+  static constexpr uint8_t NONE = 0xFF;
+
+  constexpr PieceCode() = default;
+
+  constexpr PieceCode(Colour colour, PieceType type)
+      : m_code(static_cast<uint8_t>((static_cast<uint8_t>(colour) << 3U) |
+                                    static_cast<uint8_t>(type))) {}
+
+  [[nodiscard]] static constexpr PieceCode FromRaw(uint8_t code) {
+    PieceCode piece;
+    piece.m_code = code;
+    return piece;
+  }
+
+  /**
+   * @brief Piece of a FEN letter, or an empty code if the letter is not a
+   * piece.
+   */
+  [[nodiscard]] static constexpr PieceCode FromFenChar(char ch) {
+    const Colour colour =
+        ((ch >= 'A') && (ch <= 'Z')) ? Colour::WHITE : Colour::BLACK;
+    const char lower =
+        (colour == Colour::WHITE) ? static_cast<char>(ch - 'A' + 'a') : ch;
+    for (uint8_t type = 0; type < 6; ++type) {
+      if (FEN_CHARS[1][type] == lower) {
+        return PieceCode(colour, static_cast<PieceType>(type));
+      }
+    }
+    return PieceCode();
+  }
+
+  [[nodiscard]] constexpr uint8_t GetRaw() const { return m_code; }
+
+  [[nodiscard]] constexpr bool IsNone() const { return m_code == NONE; }
+
+  /** Colour of a non-empty code. */
+  [[nodiscard]] constexpr Colour GetColour() const {
+    return static_cast<Colour>(m_code >> 3U);
+  }
+
+  /** Type of a non-empty code. */
+  [[nodiscard]] constexpr PieceType GetType() const {
+    return static_cast<PieceType>(m_code & 7U);
+  }
+
+  /** Material value of a non-empty code. */
+  [[nodiscard]] constexpr uint8_t GetValue() const {
+    return VALUES[m_code & 7U];
+  }
+
+  /** FEN letter of a non-empty code: upper case for white. */
+  [[nodiscard]] constexpr char GetFenChar() const {
+    return FEN_CHARS[m_code >> 3U][m_code & 7U];
+  }
+
+  constexpr bool operator==(const PieceCode& other) const = default;
+
+ private:
+  // Piece letters indexed by [colour][type]
+  static constexpr std::array<std::array<char, 6>, 2> FEN_CHARS{
+      {{'P', 'N', 'B', 'R', 'Q', 'K'}, {'p', 'n', 'b', 'r', 'q', 'k'}}};
+
+  static constexpr std::array<uint8_t, 6> VALUES{
+      PAWN_VALUE, KNIGHT_VALUE, BISHOP_VALUE,
+      ROOK_VALUE, QUEEN_VALUE,  KING_VALUE};
+
+  uint8_t m_code = NONE;
+};
+
+static_assert(sizeof(PieceCode) == 1);
+static_assert(PieceCode(Colour::BLACK, PieceType::KING).GetRaw() == 13);
+static_assert(PieceCode::FromFenChar('n') ==
+              PieceCode(Colour::BLACK, PieceType::KNIGHT));
+static_assert(PieceCode::FromFenChar('x').IsNone());
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_PIECECODE_HPP_
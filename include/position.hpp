@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_POSITION_HPP_
+#define _CHESS_INCLUDE_POSITION_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include "bitboard.hpp"
+#include "chess.hpp"
+#include "piececode.hpp"
+#include "psqt.hpp"
+
+namespace chess {
+
+/**
+ * @brief Piece placement stored as one bitboard per piece type, one bitboard
+ * per colour and a mailbox for square lookups. Piece counts, material and
+ * piece-square scores are kept up to date as pieces are placed and moved.
+ *
+ * The class is trivially copyable, so copying a position is a plain memcpy.
+ */
+class Position {
+ public:
+  Position();
+
+  void Clear();
+
+  void SetPiece(uint8_t index, Colour colour, PieceType type);
+  void RemovePiece(uint8_t index);
+
+  /**
+   * @brief Move the piece in src, which must not be empty, to an empty dst
+   * square.
+   */
+  void MovePiece(uint8_t src, uint8_t dst);
+
+  [[nodiscard]] bool IsEmpty(uint8_t index) const {
+    return m_mailbox[index].IsNone();
+  }
+
+  /** Piece in a square, or an empty code. */
+  [[nodiscard]] PieceCode GetPiece(uint8_t index) const {
+    return m_mailbox[index];
+  }
+
+  /** Type of the piece in a non-empty square. */
+  [[nodiscard]] PieceType GetType(uint8_t index) const {
+    return m_mailbox[index].GetType();
+  }
+
+  /** Colour of the piece in a non-empty square. */
+  [[nodiscard]] Colour GetColour(uint8_t index) const {
+    return m_mailbox[index].GetColour();
+  }
+
+  [[nodiscard]] Bitboard GetPieces(PieceType type) const {
+    return m_pieces[static_cast<uint8_t>(type)];
+  }
+
+  [[nodiscard]] Bitboard GetPieces(Colour colour) const {
+    return m_colours[static_cast<uint8_t>(colour)];
+  }
+
+  [[nodiscard]] Bitboard GetPieces(Colour colour, PieceType type) const {
+    return GetPieces(colour) & GetPieces(type);
+  }
+
+  [[nodiscard]] Bitboard GetOccupied() const {
+    return m_colours[0] | m_colours[1];
+  }
+
+  [[nodiscard]] uint8_t GetCount(Colour colour, PieceType type) const {
+    return m_counts[static_cast<uint8_t>(colour)][static_cast<uint8_t>(type)];
+  }
+
+  /**
+   * @brief Sum of the values of the pieces of a colour, the king excluded.
+   */
+  [[nodiscard]] uint16_t GetMaterial(Colour colour) const {
+    return m_material[static_cast<uint8_t>(colour)];
+  }
+
+  /**
+   * @brief Sum of the piece-square bonuses of the pieces of a colour, in
+   * centipawns.
+   */
+  [[nodiscard]] int16_t GetPsqScore(Colour colour) const {
+    return m_psq_scores[static_cast<uint8_t>(colour)];
+  }
+
+ private:
+  std::array<Bitboard, 6> m_pieces;
+  std::array<Bitboard, 2> m_colours;
+  std::array<PieceCode, NUM_SQUARES> m_mailbox;
+
+  std::array<std::array<uint8_t, 6>, 2> m_counts;
+  std::array<uint16_t, 2> m_material;
+  std::array<int16_t, 2> m_psq_scores;
+};
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_POSITION_HPP_
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_PSQT_HPP_
+#define _CHESS_INCLUDE_PSQT_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include "bitboard.hpp"
+#include "chess.hpp"
+
+namespace chess {
+
+namespace psqt {
+
+using Table = std::array<int8_t, NUM_SQUARES>;
+
+// Bonuses in centipawns for a white piece on each square, laid out as the
+// board is seen from white: the first row is rank 8. Black pieces use the
+// tables mirrored vertically.
+// clang-format off
+constexpr Table PAWN{
+     0,   0,   0,   0,   0,   0,   0,   0,
+    50,  50,  50,  50,  50,  50,  50,  50,
+    10,  10,  20,  30,  30,  20,  10,  10,
+     5,   5,  10,  25,  25,  10,   5,   5,
+     0,   0,   0,  20,  20,   0,   0,   0,
+     5,  -5, -10,   0,   0, -10,  -5,   5,
+     5,  10,  10, -20, -20,  10,  10,   5,
+     0,   0,   0,   0,   0,   0,   0,   0};
+
+constexpr Table KNIGHT{
+   -50, -40, -30, -30, -30, -30, -40, -50,
+   -40, -20,   0,   0,   0,   0, -20, -40,
+   -30,   0,  10,  15,  15,  10,   0, -30,
+   -30,   5,  15,  20,  20,  15,   5, -30,
+   -30,   0,  15,  20,  20,  15,   0, -30,
+   -30,   5,  10,  15,  15,  10,   5, -30,
+   -40, -20,   0,   5,   5,   0, -20, -40,
+   -50, -40, -30, -30, -30, -30, -40, -50};
+
+constexpr Table BISHOP{
+   -20, -10, -10, -10, -10, -10, -10, -20,
+   -10,   0,   0,   0,   0,   0,   0, -10,
+   -10,   0,   5,  10,  10,   5,   0, -10,
+   -10,   5,   5,  10,  10,   5,   5, -10,
+   -10,   0,  10,  10,  10,  10,   0, -10,
+   -10,  10,  10,  10,  10,  10,  10, -10,
+   -10,   5,   0,   0,   0,   0,   5, -10,
+   -20, -10, -10, -10, -10, -10, -10, -20};
+
+constexpr Table ROOK{
+     0,   0,   0,   0,   0,   0,   0,   0,
+     5,  10,  10,  10,  10,  10,  10,   5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+    -5,   0,   0,   0,   0,   0,   0,  -5,
+     0,   0,   0,   5,   5,   0,   0,   0};
+
+constexpr Table QUEEN{
+   -20, -10, -10,  -5,  -5, -10, -10, -20,
+   -10,   0,   0,   0,   0,   0,   0, -10,
+   -10,   0,   5,   5,   5,   5,   0, -10,
+    -5,   0,   5,   5,   5,   5,   0,  -5,
+     0,   0,   5,   5,   5,   5,   0,  -5,
+   -10,   5,   5,   5,   5,   5,   0, -10,
+   -10,   0,   5,   0,   0,   0,   0, -10,
+   -20, -10, -10,  -5,  -5, -10, -10, -20};
+
+constexpr Table KING{
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -30, -40, -40, -50, -50, -40, -40, -30,
+   -20, -30, -30, -40, -40, -30, -30, -20,
+   -10, -20, -20, -20, -20, -20, -20, -10,
+    20,  20,   0,   0,   0,   0,  20,  20,
+    20,  30,  10,   0,   0,  10,  30,  20};
+// clang-format on
+
+/**
+ * @brief Tables of both colours indexed by square index, built from the white
+ * tables above. Indexed as TABLES[colour][type][square].
+ */
+constexpr std::array<std::array<Table, 6>, 2> MakeTables() {
+  constexpr std::array<Table, 6> white_view{PAWN, KNIGHT, BISHOP,
+                                            ROOK, QUEEN,  KING};
+  std::array<std::array<Table, 6>, 2> tables{};
+
+  for (std::size_t type = 0; type < white_view.size(); ++type) {
+    for (uint8_t index = 0; index < NUM_SQUARES; ++index) {
+      // Row 0 of the white view is rank 8, index 56 to 63
+      tables[0][type][index] = white_view[type][index ^ 56U];
+      tables[1][type][index] = white_view[type][index];
+    }
+  }
+
+  return tables;
+}
+
+inline constexpr std::array<std::array<Table, 6>, 2> TABLES = MakeTables();
+
+}  // namespace psqt
+
+/**
+ * @brief Piece-square bonus in centipawns of a piece standing on a square,
+ * from the point of view of the piece's colour.
+ */
+constexpr int8_t PieceSquareValue(Colour colour, PieceType type,
+                                  uint8_t index) {
+  return psqt::TABLES[static_cast<uint8_t>(colour)]
+                     [static_cast<uint8_t>(type)][index];
+}
+
+// Both sides get the same bonus for mirrored squares
+static_assert(PieceSquareValue(Colour::WHITE, PieceType::KNIGHT, 1) ==
+              PieceSquareValue(Colour::BLACK, PieceType::KNIGHT, 57));
+static_assert(PieceSquareValue(Colour::WHITE, PieceType::PAWN, 52) == 50);
+static_assert(PieceSquareValue(Colour::BLACK, PieceType::PAWN, 12) == 50);
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_PSQT_HPP_
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_SEARCH_HPP_
+#define _CHESS_INCLUDE_SEARCH_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "board.hpp"
+#include "threadpool.hpp"
+#include "transpositiontable.hpp"
+
+namespace chess {
+
+/** Deepest ply the search can reach from the root. */
+constexpr uint8_t MAX_PLY = 64;
+
+/** Score of being checkmated at the root. Mates further away score less. */
+constexpr int MATE_SCORE = 30000;
+constexpr int INFINITE_SCORE = MATE_SCORE + 1;
+
+/**
+ * @brief Static evaluation of a position in centipawns, from the point of
+ * view of the side to move: material plus piece-square bonuses.
+ */
+[[nodiscard]] int Evaluate(const Board& board);
+
+/**
+ * @brief When to stop searching. A search with no limits runs until
+ * Search::Stop is called or MAX_PLY is reached.
+ */
+struct SearchLimits {
+  /** Maximum depth, at most MAX_PLY. */
+  uint8_t depth = MAX_PLY;
+  /** Maximum search time in milliseconds, or 0 for no limit. */
+  uint32_t msec = 0;
+};
+
+/**
+ * @brief Result of one iteration of the search, as in UCIEngine::DepthInfo.
+ */
+struct SearchInfo {
+  uint8_t depth;
+  std::vector<Move> pv;
+  /** The score counts moves to mate, negative if the side to move is mated. */
+  bool mate_counter = false;
+  int score;
+  uint64_t nodes;
+};
+
+/**
+ * @brief Best move found by the search and a suggested move to ponder, as in
+ * UCIEngine::BestMove. There is no best move if the root has no legal moves.
+ */
+struct SearchResult {
+  std::optional<Move> bestmove;
+  std::optional<Move> ponder;
+};
+
+/**
+ * @brief In-process search engine: iterative deepening negamax with
+ * alpha-beta pruning and principal variation search. Results of visited
+ * positions are kept in a transposition table, which outlives a search, so
+ * analysing consecutive positions of a game reuses earlier work.
+ *
+ * Every completed iteration is reported through the info callback and kept
+ * as the current line. An iteration interrupted by Stop or by the time limit
+ * is thrown away, so the result always comes from a fully searched depth.
+ *
+ * With several threads the search is a Lazy SMP: helper threads search the
+ * same position with staggered depths and share their results only through
+ * the transposition table, which lets the main thread cut off more nodes.
+ * The main thread alone reports lines and decides the result.
+ */
+class Search {
+ public:
+  using InfoCallback = std::function<void(const SearchInfo&)>;
+
+  Search();
+  ~Search();
+
+  Search(const Search&) = delete;
+  Search& operator=(const Search&) = delete;
+
+  /**
+   * @brief Set a function to call after every completed iteration. It runs in
+   * the searching thread.
+   */
+  void SetInfoCallback(InfoCallback callback);
+
+  /**
+   * @brief Search a position until a limit is reached. Blocks the calling
+   * thread.
+   *
+   * @param board Position to search. It is copied, so the caller's board is
+   * not touched.
+   * @param limits Depth and time limits.
+   * @param history Optional moves played to reach the position, so that
+   * repeating an earlier position scores as a draw. It is copied too. At most
+   * BoardHistory::MAX_UNDO_DEPTH - MAX_PLY moves may be pending to be unmade
+   * in it.
+   */
+  SearchResult Run(const Board& board, const SearchLimits& limits,
+                   const BoardHistory* history = nullptr);
+
+  /**
+   * @brief Ask a running search to stop. Safe to call from any thread. A stop
+   * sent before Run starts stops that search as soon as it starts, so a
+   * search started in another thread can be stopped at any time. The stop is
+   * cleared when Run returns.
+   */
+  void Stop();
+
+  /**
+   * @brief Forget a stop sent after the last search returned, before
+   * starting the next one from another thread.
+   */
+  void ClearStop();
+
+  /**
+   * @brief Set the size of the transposition table in MiB, as the Hash option
+   * of UCI engines. Its contents are lost.
+   */
+  void SetHashSize(std::size_t size_mb);
+
+  /**
+   * @brief Forget the results of previous searches, e.g. for a new game.
+   */
+  void ClearHash();
+
+  /**
+   * @brief Set the number of search threads, as the Threads option of UCI
+   * engines. Zero uses one per hardware thread. Not safe while searching.
+   */
+  void SetNumThreads(std::size_t num_threads);
+
+  [[nodiscard]] std::size_t GetNumThreads() const { return m_workers.size(); }
+
+  /**
+   * @brief Line of the last completed iteration.
+   */
+  [[nodiscard]] std::optional<SearchInfo> GetLine() const;
+
+  /**
+   * @brief Nodes visited by the last search, by all threads.
+   */
+  [[nodiscard]] uint64_t GetNodes() const { return m_nodes; }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  /** Board and principal variation of one search thread. */
+  class Worker;
+
+  InfoCallback m_info_callback;
+  TranspositionTable m_table;
+  std::optional<SearchInfo> m_line;
+
+  // The first worker runs in the calling thread, the others in the pool
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::unique_ptr<ThreadPool> m_helper_pool;
+
+  std::atomic<bool> m_stop = false;
+  std::optional<Clock::time_point> m_deadline;
+  uint64_t m_nodes = 0;
+
+  [[nodiscard]] uint64_t CountNodes() const;
+};
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_SEARCH_HPP_
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_THREADPOOL_HPP_
+#define _CHESS_INCLUDE_THREADPOOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace chess {
+
+/**
+ * @brief A fixed set of worker threads running submitted tasks.
+ *
+ * Every worker has its own task queue. Tasks are spread over the queues; a
+ * worker runs the newest task of its own queue and, when it runs out, steals
+ * the oldest task of another queue. This keeps the workers busy when tasks
+ * take very different amounts of time, as perft subtrees do.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @param num_threads Number of workers. Zero uses one per hardware thread.
+   */
+  explicit ThreadPool(std::size_t num_threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  void Submit(std::function<void()> task);
+
+  /**
+   * @brief Block until every submitted task has finished.
+   */
+  void Wait();
+
+  [[nodiscard]] std::size_t Size() const { return m_threads.size(); }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::vector<std::thread> m_threads;
+  std::atomic<std::size_t> m_next_queue = 0;
+
+  std::mutex m_mutex;
+  std::condition_variable m_work_available;
+  std::condition_variable m_all_done;
+  std::size_t m_queued = 0;
+  std::size_t m_pending = 0;
+  bool m_stop = false;
+
+  [[nodiscard]] bool PopTask(std::size_t index, std::function<void()>& task);
+  void WorkerLoop(std::size_t index);
+};
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_THREADPOOL_HPP_
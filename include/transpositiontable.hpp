@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_TRANSPOSITIONTABLE_HPP_
+#define _CHESS_INCLUDE_TRANSPOSITIONTABLE_HPP_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "packedmove.hpp"
+
+namespace chess {
+
+/**
+ * @brief Search results of positions already visited, shared by all search
+ * threads without locks.
+ *
+ * The table is split in buckets of one cache line, each holding a few
+ * entries, so a probe reads a single line. As in PerftTable, every entry is
+ * two 64-bit words written independently, the data and the position key
+ * XORed with the data, and an entry torn by concurrent writes reads as a
+ * miss.
+ */
+class TranspositionTable {
+ public:
+  /** How the stored score relates to the true score of the position. */
+  enum class Bound : uint8_t { NONE = 0, UPPER = 1, LOWER = 2, EXACT = 3 };
+
+  struct Entry {
+    PackedMove move;
+    int16_t score;
+    uint8_t depth;
+    Bound bound;
+  };
+
+  /** Size used until another one is set, as in the Hash option of UCI. */
+  static constexpr std::size_t DEFAULT_SIZE_MB = 16;
+
+  /**
+   * @param size_mb Size of the table in MiB, rounded down to a power of two
+   * number of buckets.
+   */
+  explicit TranspositionTable(std::size_t size_mb = DEFAULT_SIZE_MB);
+
+  /**
+   * @brief Reallocate the table with a new size. Every entry is lost. Not safe
+   * while a search is using the table.
+   */
+  void Resize(std::size_t size_mb);
+
+  /**
+   * @brief Forget every entry.
+   */
+  void Clear();
+
+  /**
+   * @brief Start a new search. Entries of older searches are replaced first.
+   */
+  void NewSearch() { m_age++; }
+
+  [[nodiscard]] bool Probe(uint64_t hash, Entry* entry) const;
+  void Store(uint64_t hash, const Entry& entry);
+
+  /**
+   * @brief Permille of a sample of entries written by the current search, as
+   * reported by UCI engines in hashfull.
+   */
+  [[nodiscard]] uint16_t Hashfull() const;
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> key{0};
+    std::atomic<uint64_t> data{0};
+  };
+
+  static constexpr std::size_t CACHE_LINE_SIZE = 64;
+  static constexpr std::size_t BUCKET_SIZE = CACHE_LINE_SIZE / sizeof(Slot);
+
+  struct alignas(CACHE_LINE_SIZE) Bucket {
+    std::array<Slot, BUCKET_SIZE> entries;
+  };
+  static_assert(sizeof(Bucket) == CACHE_LINE_SIZE);
+
+  std::unique_ptr<Bucket[]> m_buckets;
+  std::size_t m_mask = 0;
+  uint8_t m_age = 0;
+};
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_TRANSPOSITIONTABLE_HPP_
@@ -154,6 +154,8 @@ class UCIEngine : public QObject {
   void ParseText(const QString& text);
   BestMove ParseBestMove(const QStringList& args);
   UCIEngine::DepthInfo ParseDepthInfo(const QStringList& args);
+
+  friend class UCIEngineBench;
 };
 
 #endif  // _CHESS_INCLUDE_UCI_ENGINE_HPP_
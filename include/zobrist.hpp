@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef _CHESS_INCLUDE_ZOBRIST_HPP_
+#define _CHESS_INCLUDE_ZOBRIST_HPP_
+
+#include <array>
+#include <cstdint>
+
+#include "bitboard.hpp"
+#include "chess.hpp"
+
+namespace chess {
+
+namespace zobrist {
+
+/**
+ * @brief Random keys XORed together to identify a position. Every piece on
+ * every square, each set of castling rights, each en passant file and the side
+ * to move has its own key, so the key of a position can be updated
+ * incrementally by XORing the keys of what changes.
+ */
+struct Keys {
+  std::array<std::array<std::array<uint64_t, NUM_SQUARES>, 6>, 2> pieces;
+  std::array<uint64_t, 16> castling;
+  std::array<uint64_t, 8> en_passant;
+  uint64_t black_to_move;
+};
+
+/**
+ * @brief SplitMix64 generator. The keys are generated at compile time so they
+ * are the same in every build.
+ */
+constexpr uint64_t NextRandom(uint64_t& state) {
+  state += 0x9E3779B97F4A7C15ULL;
+  uint64_t z = state;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+constexpr Keys MakeKeys() {
+  Keys keys{};
+  uint64_t state = 0x2021;
+
+  for (auto& colour : keys.pieces) {
+    for (auto& type : colour) {
+      for (auto& key : type) {
+        key = NextRandom(state);
+      }
+    }
+  }
+  // No castling rights leaves the key unchanged
+  for (std::size_t i = 1; i < keys.castling.size(); ++i) {
+    keys.castling[i] = NextRandom(state);
+  }
+  for (auto& key : keys.en_passant) {
+    key = NextRandom(state);
+  }
+  keys.black_to_move = NextRandom(state);
+
+  return keys;
+}
+
+inline constexpr Keys KEYS = MakeKeys();
+
+}  // namespace zobrist
+
+/**
+ * @brief Key of a piece standing on a square.
+ */
+constexpr uint64_t PieceKey(Colour colour, PieceType type, uint8_t index) {
+  return zobrist::KEYS.pieces[static_cast<uint8_t>(colour)]
+                             [static_cast<uint8_t>(type)][index];
+}
+
+/**
+ * @brief Key of a set of castling rights.
+ */
+constexpr uint64_t CastlingKey(bool wkc, bool wqc, bool bkc, bool bqc) {
+  return zobrist::KEYS.castling[(wkc ? 1 : 0) | (wqc ? 2 : 0) | (bkc ? 4 : 0) |
+                                (bqc ? 8 : 0)];
+}
+
+constexpr uint64_t EnPassantKey(uint8_t file) {
+  return zobrist::KEYS.en_passant[file];
+}
+
+constexpr uint64_t SideKey(Colour colour) {
+  return (colour == Colour::BLACK) ? zobrist::KEYS.black_to_move : 0;
+}
+
+static_assert(CastlingKey(false, false, false, false) == 0);
+static_assert(PieceKey(Colour::WHITE, PieceType::PAWN, 0) !=
+              PieceKey(Colour::WHITE, PieceType::PAWN, 1));
+
+}  // namespace chess
+
+#endif  // _CHESS_INCLUDE_ZOBRIST_HPP_
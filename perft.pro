@@ -0,0 +1,19 @@
+CONFIG += c++20 console thread
+CONFIG -= qt app_bundle
+
+# No -Werror: at -O3 GCC 12 raises a false -Wrestrict positive in the
+# std::string concatenation of SquareToString
+QMAKE_CXXFLAGS += -O3 -Wall
+
+# The hash consistency checks of Board are too slow for timing
+CONFIG(release, debug|release): DEFINES += NDEBUG
+
+include (include/include.pri)
+include (src/src.pri)
+
+# Only the core library, without the Qt application
+HEADERS = $$CORE_HEADERS
+
+SOURCES = \
+  $$CORE_SOURCES \
+  tools/perft.cpp
@@ -17,35 +17,64 @@
 
 #include "board.hpp"
 
+#include "attacks.hpp"
+#include "magic.hpp"
+
 #include <algorithm>
-#include <sstream>
+#include <cassert>
+#include <type_traits>
 
 namespace chess {
 
-Board::Board(const Board& original) {
-  for (uint8_t i = 0; i < 8; ++i) {
-    for (uint8_t j = 0; j < 8; ++j) {
-      if (original.m_board[i][j]) {
-        m_board[i][j] = original.m_board[i][j]->Clone();
-      }
-    }
-  }
+static_assert(std::is_trivially_copyable_v<Board>);
+static_assert((BoardHistory::HISTORY_SIZE &
+               (BoardHistory::HISTORY_SIZE - 1)) == 0);
+
+namespace {
+
+/**
+ * @brief Squares that must not be attacked for castling: the king's square,
+ * the square it crosses and the one it lands on.
+ */
+template <Colour C, bool KING_SIDE>
+constexpr Bitboard CastlingKingPath() {
+  constexpr uint8_t rank = ColourTraits<C>::BACK_RANK;
+  return SquareBit(SquareIndex(4, rank)) |
+         SquareBit(SquareIndex(KING_SIDE ? 5 : 3, rank)) |
+         SquareBit(SquareIndex(KING_SIDE ? 6 : 2, rank));
+}
+
+}  // namespace
+
+Board::Board(const Snapshot& snapshot) { SetSnapshot(snapshot); }
 
-  m_en_passant = original.m_en_passant;
-  m_white_king_square = original.m_white_king_square;
-  m_black_king_square = original.m_black_king_square;
+Board::Snapshot Board::GetSnapshot() const {
+  return Snapshot{m_position,        m_hash,
+                  m_en_passant,      m_white_king_square,
+                  m_black_king_square, m_side_to_move,
+                  m_wkc,             m_wqc,
+                  m_bkc,             m_bqc,
+                  m_halfmove_clock,  m_fullmove_number};
+}
 
-  m_wkc = original.m_wkc;
-  m_wqc = original.m_wqc;
-  m_bkc = original.m_bkc;
-  m_bqc = original.m_bqc;
+void Board::SetSnapshot(const Snapshot& snapshot) {
+  m_position = snapshot.position;
+  m_hash = snapshot.hash;
+  m_en_passant = snapshot.en_passant;
+  m_white_king_square = snapshot.white_king_square;
+  m_black_king_square = snapshot.black_king_square;
+  m_side_to_move = snapshot.side_to_move;
+  m_wkc = snapshot.wkc;
+  m_wqc = snapshot.wqc;
+  m_bkc = snapshot.bkc;
+  m_bqc = snapshot.bqc;
+  m_halfmove_clock = snapshot.halfmove_clock;
+  m_fullmove_number = snapshot.fullmove_number;
+  m_attack_map_valid = false;
 }
 
 void Board::SetPiece(std::unique_ptr<Piece> piece, uint8_t i, uint8_t j) {
-  ClearPieceAt(i, j);
-  m_board[i][j] = std::move(piece);
-  m_board[i][j]->SetSquare({i, j});
-  SaveSquareIfKing(m_board[i][j].get());
+  SetPiece(piece->GetType(), piece->GetColour(), Square{i, j});
 }
 
 void Board::SetPiece(std::unique_ptr<Piece> piece,
@@ -55,8 +84,22 @@ void Board::SetPiece(std::unique_ptr<Piece> piece,
   SetPiece(std::move(piece), i, j);
 }
 
+void Board::SetPiece(PieceType type, Colour colour,
+                     const chess::Square& square) {
+  ClearPieceAt(square);
+  m_attack_map_valid = false;
+  m_position.SetPiece(SquareIndex(square), colour, type);
+  m_hash ^= PieceKey(colour, type, SquareIndex(square));
+  SaveSquareIfKing(square);
+}
+
 const Piece* Board::PieceAt(uint8_t i, uint8_t j) const {
-  return m_board[i][j].get();
+  const uint8_t index = SquareIndex(i, j);
+  if (m_position.IsEmpty(index)) {
+    return nullptr;
+  }
+
+  return Piece::Get(m_position.GetType(index), m_position.GetColour(index));
 }
 
 const Piece* Board::PieceAt(const chess::Square& square) const {
@@ -65,9 +108,24 @@ const Piece* Board::PieceAt(const chess::Square& square) const {
   return PieceAt(i, j);
 }
 
+PieceCode Board::GetPiece(const chess::Square& square) const {
+  return m_position.GetPiece(SquareIndex(square));
+}
+
 void Board::ClearPieceAt(uint8_t i, uint8_t j) {
-  if (m_board[i][j].get() != nullptr) {
-    m_board[i][j].reset();
+  m_attack_map_valid = false;
+  const Square square{i, j};
+  if (m_white_king_square == square) {
+    m_white_king_square.reset();
+  } else if (m_black_king_square == square) {
+    m_black_king_square.reset();
+  }
+
+  const uint8_t index = SquareIndex(square);
+  if (!m_position.IsEmpty(index)) {
+    m_hash ^= PieceKey(m_position.GetColour(index), m_position.GetType(index),
+                       index);
+    m_position.RemovePiece(index);
   }
 }
 
@@ -77,214 +135,942 @@ void Board::ClearPieceAt(const chess::Square& square) {
   ClearPieceAt(i, j);
 }
 
-void Board::SaveSquareIfKing(Piece* const piece) {
-  if (piece == nullptr) {
+void Board::SaveSquareIfKing(const Square& square) {
+  const uint8_t index = SquareIndex(square);
+  if (m_position.IsEmpty(index) ||
+      (m_position.GetType(index) != PieceType::KING)) {
     return;
   }
 
-  const auto type = piece->GetType();
-  const auto colour = piece->GetColour();
-  if (type == PieceType::KING) {
-    if (colour == Colour::WHITE) {
-      m_white_king_square = piece->GetSquare();
-    } else {
-      m_black_king_square = piece->GetSquare();
-    }
+  if (m_position.GetColour(index) == Colour::WHITE) {
+    m_white_king_square = square;
+  } else {
+    m_black_king_square = square;
+  }
+}
+
+void Board::DoMove(const Move& move) {
+  const PieceCode piece = GetPiece(move.src);
+  if (piece.IsNone()) {
+    return;
   }
+
+  m_attack_map_valid = false;
+
+  // Dispatch on the colour of the moving piece, so that moves set up out of
+  // turn are still played by their own rules.
+  if (piece.GetColour() == Colour::WHITE) {
+    DoMove<Colour::WHITE>(move);
+  } else {
+    DoMove<Colour::BLACK>(move);
+  }
+}
+
+void Board::DoMove(const Move& move, BoardHistory& history) {
+  if (GetPiece(move.src).IsNone()) {
+    return;
+  }
+
+  history.m_keys[history.m_num_keys++ & (BoardHistory::HISTORY_SIZE - 1)] =
+      m_hash;
+  DoMove(move);
 }
 
+template <Colour Us>
 void Board::DoMove(const Move& move) {
+  using Traits = ColourTraits<Us>;
+  const PieceCode piece = GetPiece(move.src);
+  const bool is_pawn_move = (piece == PieceCode(Us, PieceType::PAWN));
+  const bool is_king_move = (piece == PieceCode(Us, PieceType::KING));
+  const bool is_double_push = is_pawn_move &&
+                              (move.src.rank == Traits::PAWN_START_RANK) &&
+                              (move.dst.rank == Traits::DOUBLE_PUSH_RANK);
+  const bool is_capture = !m_position.IsEmpty(SquareIndex(move.dst));
+
+  if (is_pawn_move || is_capture) {
+    m_halfmove_clock = 0;
+  } else {
+    m_halfmove_clock++;
+  }
+  if (m_side_to_move == Colour::BLACK) {
+    m_fullmove_number++;
+  }
+
   // Handle special moves first
-  if (MoveIsWKC(move)) {
-    MovePieces(move);
-    MovePieces(WHITE_KING_ROOK_CASTLE);
-  } else if (MoveIsWQC(move)) {
+  if (is_king_move && (move == Traits::KING_CASTLE)) {
     MovePieces(move);
-    MovePieces(WHITE_QUEEN_ROOK_CASTLE);
-  } else if (MoveIsBKC(move)) {
+    MovePieces(Traits::KING_ROOK_CASTLE);
+  } else if (is_king_move && (move == Traits::QUEEN_CASTLE)) {
     MovePieces(move);
-    MovePieces(BLACK_KING_ROOK_CASTLE);
-  } else if (MoveIsBQC(move)) {
-    MovePieces(move);
-    MovePieces(BLACK_QUEEN_ROOK_CASTLE);
-  } else if (MoveIsPawnPromotion(move)) {
+    MovePieces(Traits::QUEEN_ROOK_CASTLE);
+  } else if (move.is_pawn_promotion &&
+             (move.src.rank == Traits::RelativeRank(6)) &&
+             (move.dst.rank == Traits::PROMOTION_RANK)) {
     MoveForPromotion(move);
-  } else if (MoveIsEnPassant(move)) {
+  } else if (is_pawn_move && (m_en_passant == move.dst) &&
+             (move.src.file != move.dst.file)) {
+    MovePieces(move);
+    ClearPieceAt(move.dst.file, move.src.rank);
   } else {
     MovePieces(move);
   }
+
+  if (is_double_push) {
+    SetEnPassant(Square{move.src.file, Traits::RelativeRank(2)});
+  } else {
+    SetEnPassant(std::nullopt);
+  }
+
+  ToggleColour(&m_side_to_move);
+  m_hash ^= zobrist::KEYS.black_to_move;
 }
 
-void Board::MovePieces(const Move& move) {
-  auto& src = m_board[move.src.file][move.src.rank];
-  auto& dst = m_board[move.dst.file][move.dst.rank];
+void Board::SetEnPassant(const std::optional<Square>& en_passant) {
+  if (m_en_passant.has_value()) {
+    m_hash ^= EnPassantKey(m_en_passant->file);
+  }
+  m_en_passant = en_passant;
+  if (m_en_passant.has_value()) {
+    m_hash ^= EnPassantKey(m_en_passant->file);
+  }
+}
 
-  dst.swap(src);
-  dst->SetSquare(move.dst);
-  dst->SetMoved(true);
-  SaveSquareIfKing(dst.get());
-  UpdateCastles();
-  src.reset();
+void Board::MakeMove(const Move& move, BoardHistory& history) {
+  assert(!GetPiece(move.src).IsNone());
+  assert(history.m_undo_size < BoardHistory::MAX_UNDO_DEPTH);
+  BoardHistory::UndoInfo& undo =
+      history.m_undo_stack[history.m_undo_size++];
+
+  undo.move = move;
+  undo.is_promotion = MoveIsPawnPromotion(move);
+  undo.captured_square =
+      MoveIsEnPassant(move) ? Square{move.dst.file, move.src.rank} : move.dst;
+  const uint8_t captured_index = SquareIndex(undo.captured_square);
+  if (m_position.IsEmpty(captured_index)) {
+    undo.captured.reset();
+  } else {
+    undo.captured = m_position.GetType(captured_index);
+  }
+
+  undo.en_passant = m_en_passant;
+  undo.side_to_move = m_side_to_move;
+  undo.white_king_square = m_white_king_square;
+  undo.black_king_square = m_black_king_square;
+  undo.wkc = m_wkc;
+  undo.wqc = m_wqc;
+  undo.bkc = m_bkc;
+  undo.bqc = m_bqc;
+  undo.halfmove_clock = m_halfmove_clock;
+  undo.fullmove_number = m_fullmove_number;
+  undo.hash = m_hash;
+
+  DoMove(move, history);
+  assert(m_hash == ComputeHash());
 }
 
-void Board::MoveForPromotion(const Move& move) {
-  auto& src = m_board[move.src.file][move.src.rank];
-  auto& dst = m_board[move.dst.file][move.dst.rank];
+void Board::UnmakeMove(BoardHistory& history) {
+  assert((history.m_undo_size > 0) && (history.m_num_keys > 0));
+  m_attack_map_valid = false;
+  history.m_num_keys--;
+  const BoardHistory::UndoInfo& undo =
+      history.m_undo_stack[--history.m_undo_size];
+  const Move& move = undo.move;
+  const uint8_t src = SquareIndex(move.src);
+  const uint8_t dst = SquareIndex(move.dst);
+  const Colour colour = m_position.GetColour(dst);
+
+  if (undo.is_promotion) {
+    m_position.RemovePiece(dst);
+    m_position.SetPiece(src, colour, PieceType::PAWN);
+  } else {
+    const bool is_castling = (m_position.GetType(dst) == PieceType::KING) &&
+                             ((move.src.file + 2 == move.dst.file) ||
+                              (move.dst.file + 2 == move.src.file));
+    m_position.MovePiece(dst, src);
+
+    if (is_castling) {
+      const bool king_side = (move.dst.file == 6);
+      const uint8_t rook_src = SquareIndex(king_side ? 7 : 0, move.src.rank);
+      const uint8_t rook_dst = SquareIndex(king_side ? 5 : 3, move.src.rank);
+      m_position.MovePiece(rook_dst, rook_src);
+    }
+  }
 
-  const auto* src_piece = PieceAt(move.src);
-  const PieceType type = move.promotion_type;
-  const Colour colour = src_piece->GetColour();
+  if (undo.captured.has_value()) {
+    m_position.SetPiece(SquareIndex(undo.captured_square),
+                        OppositeColour(colour), undo.captured.value());
+  }
 
-  // Reset both pieces
-  src.reset();
-  dst.reset();
+  m_en_passant = undo.en_passant;
+  m_side_to_move = undo.side_to_move;
+  m_white_king_square = undo.white_king_square;
+  m_black_king_square = undo.black_king_square;
+  m_wkc = undo.wkc;
+  m_wqc = undo.wqc;
+  m_bkc = undo.bkc;
+  m_bqc = undo.bqc;
+  m_halfmove_clock = undo.halfmove_clock;
+  m_fullmove_number = undo.fullmove_number;
+  m_hash = undo.hash;
+  assert(m_hash == ComputeHash());
+}
 
-  // Set promoted piece at dst square
-  std::unique_ptr<Piece> promoted_piece = Piece::Factory(type, colour);
-  SetPiece(std::move(promoted_piece), move.dst);
+void Board::MovePieces(const Move& move) {
+  // Position::MovePiece indexes its sets by the type and colour of the piece
+  const uint8_t src = SquareIndex(move.src);
+  if (m_position.IsEmpty(src)) {
+    return;
+  }
 
-  dst->SetSquare(move.dst);
-  dst->SetMoved(true);
-  UpdateCastles();
+  ClearPieceAt(move.dst);
+  const uint8_t dst = SquareIndex(move.dst);
+  const Colour colour = m_position.GetColour(src);
+  const PieceType type = m_position.GetType(src);
+  m_hash ^= PieceKey(colour, type, src) ^ PieceKey(colour, type, dst);
+  m_position.MovePiece(src, dst);
+  SaveSquareIfKing(move.dst);
+  UpdateCastles(move);
+}
+
+void Board::MoveForPromotion(const Move& move) {
+  const Colour colour = m_position.GetColour(SquareIndex(move.src));
+
+  ClearPieceAt(move.src);
+  SetPiece(move.promotion_type, colour, move.dst);
+  UpdateCastles(move);
 }
 
 void Board::Clear() {
-  for (uint8_t i = 0; i < 8; ++i) {
-    for (uint8_t j = 0; j < 8; ++j) {
-      ClearPieceAt(i, j);
-    }
-  }
+  m_attack_map_valid = false;
+  m_position.Clear();
+  m_white_king_square.reset();
+  m_black_king_square.reset();
+  m_hash = ComputeHash();
 }
 
 void Board::SetCastling(bool wkc, bool wqc, bool bkc, bool bqc) {
+  m_hash ^= CastlingKey(m_wkc, m_wqc, m_bkc, m_bqc);
   m_wkc = wkc;
   m_wqc = wqc;
   m_bkc = bkc;
   m_bqc = bqc;
+  m_hash ^= CastlingKey(m_wkc, m_wqc, m_bkc, m_bqc);
+}
+
+uint64_t Board::ComputeHash() const {
+  uint64_t hash = 0;
+
+  Bitboard occupied = m_position.GetOccupied();
+  while (occupied != EMPTY_BITBOARD) {
+    const uint8_t index = PopLsb(occupied);
+    hash ^= PieceKey(m_position.GetColour(index), m_position.GetType(index),
+                     index);
+  }
+
+  hash ^= CastlingKey(m_wkc, m_wqc, m_bkc, m_bqc);
+  if (m_en_passant.has_value()) {
+    hash ^= EnPassantKey(m_en_passant->file);
+  }
+  hash ^= SideKey(m_side_to_move);
+
+  return hash;
 }
 
 std::string Board::GetPosition(const Colour& active_colour) const {
-  std::stringstream ss;
-
-  uint8_t empty_count;
-  for (uint8_t j = 0; j < 8; ++j) {
-    empty_count = 0;
-    for (uint8_t i = 0; i < 8; ++i) {
-      auto piece = m_board[i][7 - j].get();
-      if (piece == nullptr) {
+  FenBuffer buffer;
+  const std::size_t length =
+      WriteFEN(buffer.data(), active_colour, /*with_counters=*/false);
+  return std::string(buffer.data(), length);
+}
+
+std::string Board::GetFEN() const {
+  FenBuffer buffer;
+  return std::string(buffer.data(), WriteFEN(buffer));
+}
+
+std::size_t Board::WriteFEN(FenBuffer& buffer) const {
+  return WriteFEN(buffer.data(), m_side_to_move, /*with_counters=*/true);
+}
+
+/**
+ * @brief Write a number without leading zeros. Returns the end of the
+ * written digits.
+ */
+static char* WriteNumber(char* out, uint16_t number) {
+  char digits[5];
+  std::size_t count = 0;
+  do {
+    digits[count++] = static_cast<char>('0' + (number % 10));
+    number /= 10;
+  } while (number > 0);
+
+  while (count > 0) {
+    *out++ = digits[--count];
+  }
+  return out;
+}
+
+std::size_t Board::WriteFEN(char* buffer, Colour active_colour,
+                            bool with_counters) const {
+  char* out = buffer;
+  for (int rank = 7; rank >= 0; --rank) {
+    char empty_count = 0;
+    for (uint8_t file = 0; file < 8; ++file) {
+      const uint8_t index = SquareIndex(file, static_cast<uint8_t>(rank));
+      if (m_position.IsEmpty(index)) {
         empty_count++;
-      } else {
-        if (empty_count > 0) {
-          ss << std::to_string(empty_count);
-          empty_count = 0;
-        }
-        ss << std::string{piece->GetFenChar()};
+        continue;
       }
+      if (empty_count > 0) {
+        *out++ = static_cast<char>('0' + empty_count);
+        empty_count = 0;
+      }
+      *out++ = m_position.GetPiece(index).GetFenChar();
     }
-
     if (empty_count > 0) {
-      ss << std::to_string(empty_count);
-    }
-    if (j != 7) {
-      ss << "/";
-    } else {
-      ss << " ";
+      *out++ = static_cast<char>('0' + empty_count);
     }
+    *out++ = (rank > 0) ? '/' : ' ';
   }
 
-  ss << ((active_colour == Colour::WHITE) ? "w " : "b ");
+  *out++ = (active_colour == Colour::WHITE) ? 'w' : 'b';
+  *out++ = ' ';
 
-  const bool some_castling_possible = m_wkc || m_wqc || m_bkc || m_bqc;
+  if (m_wkc || m_wqc || m_bkc || m_bqc) {
+    if (m_wkc) {
+      *out++ = 'K';
+    }
+    if (m_wqc) {
+      *out++ = 'Q';
+    }
+    if (m_bkc) {
+      *out++ = 'k';
+    }
+    if (m_bqc) {
+      *out++ = 'q';
+    }
+  } else {
+    *out++ = '-';
+  }
+  *out++ = ' ';
 
-  if (some_castling_possible) {
-    ss << (m_wkc ? "K" : "");
-    ss << (m_wqc ? "Q" : "");
-    ss << (m_bkc ? "k" : "");
-    ss << (m_bqc ? "q" : "");
-    ss << " ";
+  if (m_en_passant.has_value()) {
+    *out++ = static_cast<char>('a' + m_en_passant->file);
+    *out++ = static_cast<char>('1' + m_en_passant->rank);
   } else {
-    ss << "- ";
+    *out++ = '-';
   }
 
-  ss << ((m_en_passant.has_value()) ? SquareToString(m_en_passant.value())
-                                    : "-");
+  if (with_counters) {
+    *out++ = ' ';
+    out = WriteNumber(out, m_halfmove_clock);
+    *out++ = ' ';
+    out = WriteNumber(out, m_fullmove_number);
+  }
 
-  return ss.str();
+  *out = '\0';
+  return static_cast<std::size_t>(out - buffer);
 }
 
-[[nodiscard]] bool Board::CanWKC() const {
-  if (!m_wkc || IsInCheck(Colour::WHITE)) {
-    return false;
+const char* FenErrorToString(FenError error) {
+  switch (error) {
+    case FenError::NONE:
+      return "No error";
+    case FenError::INVALID_PIECE:
+      return "Invalid piece";
+    case FenError::INVALID_RANK_LENGTH:
+      return "Rank does not have 8 squares";
+    case FenError::INVALID_RANK_COUNT:
+      return "Board does not have 8 ranks";
+    case FenError::INVALID_KING_COUNT:
+      return "Each side must have exactly one king";
+    case FenError::TOO_MANY_PIECES:
+      return "A side has more than 16 pieces";
+    case FenError::TOO_MANY_PAWNS:
+      return "A side has more than 8 pawns";
+    case FenError::PAWN_ON_BACK_RANK:
+      return "Pawn on the first or last rank";
+    case FenError::MISSING_FIELD:
+      return "Missing field";
+    case FenError::INVALID_SIDE_TO_MOVE:
+      return "Invalid side to move";
+    case FenError::INVALID_CASTLING:
+      return "Invalid castling rights";
+    case FenError::INVALID_EN_PASSANT:
+      return "Invalid en passant square";
+    case FenError::INVALID_HALFMOVE_CLOCK:
+      return "Invalid half-move clock";
+    case FenError::INVALID_FULLMOVE_NUMBER:
+      return "Invalid full-move number";
+    case FenError::TRAILING_CHARACTERS:
+      return "Unexpected characters after the last field";
   }
 
-  constexpr std::array<Square, 3> path{Square{5, 0}, {6, 0}, {7, 0}};
-  for (const auto& sq : path) {
-    if (CanBeCaptured(sq)) {
-      return false;
+  return "Unknown error";
+}
+
+FenResult Board::FromFEN(std::string_view fen) {
+  m_position.Clear();
+  m_white_king_square.reset();
+  m_black_king_square.reset();
+  m_en_passant.reset();
+  m_side_to_move = Colour::WHITE;
+  m_wkc = m_wqc = m_bkc = m_bqc = false;
+  m_halfmove_clock = 0;
+  m_fullmove_number = 1;
+  m_attack_map_valid = false;
+
+  std::size_t pos = 0;
+  const auto fail = [&](FenError error) {
+    m_position.Clear();
+    m_white_king_square.reset();
+    m_black_king_square.reset();
+    m_en_passant.reset();
+    m_side_to_move = Colour::WHITE;
+    m_wkc = m_wqc = m_bkc = m_bqc = false;
+    m_halfmove_clock = 0;
+    m_fullmove_number = 1;
+    m_hash = ComputeHash();
+    return FenResult{error, pos};
+  };
+  const auto skip_spaces = [&] {
+    while ((pos < fen.size()) && (fen[pos] == ' ')) {
+      pos++;
+    }
+  };
+  const auto at_field_end = [&] {
+    return (pos >= fen.size()) || (fen[pos] == ' ');
+  };
+  const auto parse_number = [&](uint16_t* number) {
+    uint32_t value = 0;
+    const std::size_t start = pos;
+    while (!at_field_end() && (fen[pos] >= '0') && (fen[pos] <= '9')) {
+      value = 10 * value + (fen[pos] - '0');
+      if (value > UINT16_MAX) {
+        return false;
+      }
+      pos++;
+    }
+    *number = static_cast<uint16_t>(value);
+    return (pos > start) && at_field_end();
+  };
+
+  // Piece placement, from rank 8 to rank 1
+  skip_spaces();
+  uint8_t file = 0;
+  uint8_t rank = 7;
+  for (; !at_field_end(); ++pos) {
+    const char ch = fen[pos];
+    if (ch == '/') {
+      if (file != 8) {
+        return fail(FenError::INVALID_RANK_LENGTH);
+      }
+      if (rank == 0) {
+        return fail(FenError::INVALID_RANK_COUNT);
+      }
+      file = 0;
+      rank--;
+      continue;
+    }
+
+    if ((ch >= '1') && (ch <= '8')) {
+      file += ch - '0';
+      if (file > 8) {
+        return fail(FenError::INVALID_RANK_LENGTH);
+      }
+      continue;
     }
+
+    const PieceCode piece = PieceCode::FromFenChar(ch);
+    if (piece.IsNone()) {
+      return fail(FenError::INVALID_PIECE);
+    }
+    if (file >= 8) {
+      return fail(FenError::INVALID_RANK_LENGTH);
+    }
+
+    m_position.SetPiece(SquareIndex(file, rank), piece.GetColour(),
+                        piece.GetType());
+    SaveSquareIfKing(Square{file, rank});
+    file++;
+  }
+  if (file != 8) {
+    return fail(FenError::INVALID_RANK_LENGTH);
+  }
+  if (rank != 0) {
+    return fail(FenError::INVALID_RANK_COUNT);
   }
 
-  return true;
-}
+  // Move generation relies on one king per side and on the material of a
+  // legal game, which bounds the number of moves of a position
+  for (const Colour colour : {Colour::WHITE, Colour::BLACK}) {
+    if (PopCount(m_position.GetPieces(colour, PieceType::KING)) != 1) {
+      return fail(FenError::INVALID_KING_COUNT);
+    }
+    if (PopCount(m_position.GetPieces(colour)) > 16) {
+      return fail(FenError::TOO_MANY_PIECES);
+    }
+    if (PopCount(m_position.GetPieces(colour, PieceType::PAWN)) > 8) {
+      return fail(FenError::TOO_MANY_PAWNS);
+    }
+  }
+  constexpr Bitboard BACK_RANKS = RankBitboard(0) | RankBitboard(7);
+  if ((m_position.GetPieces(PieceType::PAWN) & BACK_RANKS) != EMPTY_BITBOARD) {
+    return fail(FenError::PAWN_ON_BACK_RANK);
+  }
 
-[[nodiscard]] bool Board::CanWQC() const {
-  if (!m_wqc || IsInCheck(Colour::WHITE)) {
-    return false;
+  // Side to move
+  skip_spaces();
+  if (pos >= fen.size()) {
+    return fail(FenError::MISSING_FIELD);
+  }
+  if ((fen[pos] != 'w') && (fen[pos] != 'b')) {
+    return fail(FenError::INVALID_SIDE_TO_MOVE);
+  }
+  m_side_to_move = (fen[pos++] == 'w') ? Colour::WHITE : Colour::BLACK;
+  if (!at_field_end()) {
+    return fail(FenError::INVALID_SIDE_TO_MOVE);
   }
 
-  constexpr std::array<Square, 5> path{Square{3, 0}, {2, 0}, {1, 0}, {0, 0}};
-  for (const auto& sq : path) {
-    if (CanBeCaptured(sq)) {
-      return false;
+  // Castling rights
+  skip_spaces();
+  if (pos >= fen.size()) {
+    return fail(FenError::MISSING_FIELD);
+  }
+  if (fen[pos] == '-') {
+    pos++;
+  } else {
+    for (; !at_field_end(); ++pos) {
+      switch (fen[pos]) {
+        case 'K':
+          m_wkc = true;
+          break;
+        case 'Q':
+          m_wqc = true;
+          break;
+        case 'k':
+          m_bkc = true;
+          break;
+        case 'q':
+          m_bqc = true;
+          break;
+        default:
+          return fail(FenError::INVALID_CASTLING);
+      }
     }
   }
+  if (!at_field_end()) {
+    return fail(FenError::INVALID_CASTLING);
+  }
 
-  return true;
-}
+  // En passant square, behind a pawn that has just moved two squares
+  skip_spaces();
+  if (pos >= fen.size()) {
+    return fail(FenError::MISSING_FIELD);
+  }
+  if (fen[pos] == '-') {
+    pos++;
+  } else {
+    const char en_passant_rank = (m_side_to_move == Colour::WHITE) ? '6' : '3';
+    if ((pos + 1 >= fen.size()) || (fen[pos] < 'a') || (fen[pos] > 'h') ||
+        (fen[pos + 1] != en_passant_rank)) {
+      return fail(FenError::INVALID_EN_PASSANT);
+    }
+    m_en_passant = Square{static_cast<uint8_t>(fen[pos] - 'a'),
+                          static_cast<uint8_t>(fen[pos + 1] - '1')};
+    pos += 2;
+  }
+  if (!at_field_end()) {
+    return fail(FenError::INVALID_EN_PASSANT);
+  }
 
-[[nodiscard]] bool Board::CanBKC() const {
-  if (!m_bkc || IsInCheck(Colour::BLACK)) {
-    return false;
+  // Move counters, which are often left out
+  skip_spaces();
+  if ((pos < fen.size()) && !parse_number(&m_halfmove_clock)) {
+    return fail(FenError::INVALID_HALFMOVE_CLOCK);
+  }
+  skip_spaces();
+  if (pos < fen.size()) {
+    if (!parse_number(&m_fullmove_number)) {
+      return fail(FenError::INVALID_FULLMOVE_NUMBER);
+    }
+    m_fullmove_number = std::max<uint16_t>(m_fullmove_number, 1);
   }
 
-  constexpr std::array<Square, 3> path{Square{5, 7}, {6, 7}, {7, 7}};
-  for (const auto& sq : path) {
-    if (CanBeCaptured(sq)) {
-      return false;
+  skip_spaces();
+  if (pos < fen.size()) {
+    return fail(FenError::TRAILING_CHARACTERS);
+  }
+
+  m_hash = ComputeHash();
+  return FenResult{};
+}
+
+bool Board::SetPosition(std::string_view fen) { return FromFEN(fen).IsOk(); }
+
+uint16_t Board::GetHalfmoveClock() const { return m_halfmove_clock; }
+
+uint16_t Board::GetFullmoveNumber() const { return m_fullmove_number; }
+
+uint8_t Board::CountRepetitions(const BoardHistory& history) const {
+  constexpr std::size_t HISTORY_SIZE = BoardHistory::HISTORY_SIZE;
+  const std::size_t num_keys = history.m_num_keys;
+  const std::size_t plies = std::min(
+      {static_cast<std::size_t>(m_halfmove_clock), num_keys, HISTORY_SIZE});
+
+  // Only positions with the same side to move can be equal
+  uint8_t count = 0;
+  for (std::size_t back = 2; back <= plies; back += 2) {
+    if (history.m_keys[(num_keys - back) & (HISTORY_SIZE - 1)] == m_hash) {
+      count++;
     }
   }
+  return count;
+}
 
-  return true;
+[[nodiscard]] bool Board::CanWKC() const {
+  return CanCastle<Colour::WHITE, true>();
+}
+
+[[nodiscard]] bool Board::CanWQC() const {
+  return CanCastle<Colour::WHITE, false>();
+}
+
+[[nodiscard]] bool Board::CanBKC() const {
+  return CanCastle<Colour::BLACK, true>();
 }
 
 [[nodiscard]] bool Board::CanBQC() const {
-  if (!m_bqc || IsInCheck(Colour::BLACK)) {
+  return CanCastle<Colour::BLACK, false>();
+}
+
+template <Colour C, bool KING_SIDE>
+bool Board::HasCastlingPath() const {
+  using Traits = ColourTraits<C>;
+  const bool has_right = Traits::IS_WHITE ? (KING_SIDE ? m_wkc : m_wqc)
+                                          : (KING_SIDE ? m_bkc : m_bqc);
+  if (!has_right) {
     return false;
   }
 
-  constexpr std::array<Square, 5> path{Square{3, 7}, {2, 7}, {1, 7}, {0, 7}};
-  for (const auto& sq : path) {
-    if (CanBeCaptured(sq)) {
+  constexpr uint8_t king = SquareIndex(4, Traits::BACK_RANK);
+  constexpr uint8_t rook = SquareIndex(KING_SIDE ? 7 : 0, Traits::BACK_RANK);
+  if (((m_position.GetPieces(C, PieceType::KING) & SquareBit(king)) ==
+       EMPTY_BITBOARD) ||
+      ((m_position.GetPieces(C, PieceType::ROOK) & SquareBit(rook)) ==
+       EMPTY_BITBOARD)) {
+    return false;
+  }
+
+  // The squares between the king and the rook must be empty
+  return (m_position.GetOccupied() & BETWEEN_SQUARES[king][rook]) ==
+         EMPTY_BITBOARD;
+}
+
+template <Colour C, bool KING_SIDE>
+bool Board::CanCastle() const {
+  // The king cannot castle out of check, nor pass through or land on an
+  // attacked square. The few squares are tested directly rather than by
+  // building the whole attack map.
+  if (!HasCastlingPath<C, KING_SIDE>()) {
+    return false;
+  }
+  const Bitboard occupied = m_position.GetOccupied();
+  Bitboard path = CastlingKingPath<C, KING_SIDE>();
+  while (path != EMPTY_BITBOARD) {
+    if (IsAttackedBy<ColourTraits<C>::THEM>(PopLsb(path), occupied)) {
       return false;
     }
   }
-
   return true;
 }
 
-std::vector<Move> Board::GetMovesFrom(uint8_t i, uint8_t j) const {
+void Board::GetMovesFrom(uint8_t i, uint8_t j, MoveList& moves) const {
   const Square square{i, j};
-  return GetMovesFrom(square);
+  GetMovesFrom(square, moves);
+}
+
+void Board::GetMovesFrom(const Square& square, MoveList& moves) const {
+  const PieceCode piece = GetPiece(square);
+  if (piece.IsNone()) {
+    return;
+  }
+
+  GetPieceMoves(*this, piece, square, moves);
+}
+
+void Board::GenerateMoves(MoveList& moves) const {
+  if (m_side_to_move == Colour::WHITE) {
+    GenerateMoves<Colour::WHITE>(moves);
+  } else {
+    GenerateMoves<Colour::BLACK>(moves);
+  }
+}
+
+template <Colour Us>
+void Board::GenerateMoves(MoveList& moves) const {
+  Bitboard pieces = m_position.GetPieces(Us);
+  while (pieces != EMPTY_BITBOARD) {
+    const uint8_t index = PopLsb(pieces);
+    GetPieceMoves<Us>(*this, m_position.GetType(index), IndexToSquare(index),
+                      moves);
+  }
+}
+
+template void Board::GenerateMoves<Colour::WHITE>(MoveList& moves) const;
+template void Board::GenerateMoves<Colour::BLACK>(MoveList& moves) const;
+
+void Board::GenerateLegalMoves(MoveList& moves, MoveGenType type) const {
+  const bool is_white = (m_side_to_move == Colour::WHITE);
+  switch (type) {
+    case MoveGenType::ALL:
+      if (is_white) {
+        GenerateLegalMoves<Colour::WHITE>(moves);
+      } else {
+        GenerateLegalMoves<Colour::BLACK>(moves);
+      }
+      break;
+    case MoveGenType::NOISY:
+      if (is_white) {
+        GenerateLegalMoves<Colour::WHITE, MoveGenType::NOISY>(moves);
+      } else {
+        GenerateLegalMoves<Colour::BLACK, MoveGenType::NOISY>(moves);
+      }
+      break;
+    case MoveGenType::QUIET:
+      if (is_white) {
+        GenerateLegalMoves<Colour::WHITE, MoveGenType::QUIET>(moves);
+      } else {
+        GenerateLegalMoves<Colour::BLACK, MoveGenType::QUIET>(moves);
+      }
+      break;
+  }
+}
+
+template <Colour Us, MoveGenType Type>
+void Board::GenerateLegalMoves(MoveList& moves) const {
+  using Traits = ColourTraits<Us>;
+  constexpr Colour them = Traits::THEM;
+  const Bitboard own = m_position.GetPieces(Us);
+  const Bitboard enemy = m_position.GetPieces(them);
+  const Bitboard occupied = own | enemy;
+  const Bitboard king = m_position.GetPieces(Us, PieceType::KING);
+
+  // A board without a king, e.g. while a position is being set up, has no
+  // checks or pins to take into account.
+  if (king == EMPTY_BITBOARD) {
+    if constexpr (Type == MoveGenType::ALL) {
+      GenerateMoves<Us>(moves);
+    } else {
+      MoveList all_moves;
+      GenerateMoves<Us>(all_moves);
+      for (const Move& move : all_moves) {
+        if (IsNoisyMove(move) == (Type == MoveGenType::NOISY)) {
+          moves.Add(move);
+        }
+      }
+    }
+    return;
+  }
+
+  // Squares the pieces other than pawns can move to
+  Bitboard targets = ~own;
+  if constexpr (Type == MoveGenType::NOISY) {
+    targets = enemy;
+  } else if constexpr (Type == MoveGenType::QUIET) {
+    targets = ~occupied;
+  }
+  const Bitboard promotion_rank = RankBitboard(Traits::PROMOTION_RANK);
+
+  const uint8_t king_index = Lsb(king);
+  const Square king_square = IndexToSquare(king_index);
+  const Bitboard checkers = AttackersTo(king_index, occupied) & enemy;
+
+  // The king cannot step to an attacked square, nor along the line of a
+  // slider that is checking it, so it is removed from the occupancy.
+  Bitboard king_targets = KING_ATTACKS[king_index] & targets;
+  while (king_targets != EMPTY_BITBOARD) {
+    const uint8_t dst = PopLsb(king_targets);
+    if (!IsAttackedBy<them>(dst, occupied ^ king)) {
+      moves.Add(Move{king_square, IndexToSquare(dst)});
+    }
+  }
+
+  // In double check only the king can move
+  if (PopCount(checkers) > 1) {
+    return;
+  }
+
+  // In check, other pieces must capture the checker or block the check
+  Bitboard check_mask = ~EMPTY_BITBOARD;
+  if (checkers != EMPTY_BITBOARD) {
+    const uint8_t checker = Lsb(checkers);
+    check_mask = BETWEEN_SQUARES[king_index][checker] | checkers;
+  } else if constexpr (Type != MoveGenType::NOISY) {
+    GenerateCastles<Us>(moves);
+  }
+
+  std::array<Bitboard, NUM_SQUARES> pin_rays;
+  const Bitboard pinned = PinnedPieces<Us>(king_index, occupied, pin_rays);
+
+  Bitboard pieces = own & ~king;
+  while (pieces != EMPTY_BITBOARD) {
+    const uint8_t src = PopLsb(pieces);
+    const Square src_square = IndexToSquare(src);
+    const Bitboard pin_mask =
+        ((pinned & SquareBit(src)) != EMPTY_BITBOARD) ? pin_rays[src]
+                                                      : ~EMPTY_BITBOARD;
+    const Bitboard mask = check_mask & pin_mask;
+
+    switch (m_position.GetType(src)) {
+      case PieceType::PAWN: {
+        const Bitboard bit = SquareBit(src);
+        const Bitboard single_push = PawnPush<Us>(bit) & ~occupied;
+        Bitboard pushes = single_push;
+        if (src_square.rank == Traits::PAWN_START_RANK) {
+          pushes |= PawnPush<Us>(single_push) & ~occupied;
+        }
+        const Bitboard captures = PawnAttacks(Us, src) & enemy;
+        Bitboard pawn_targets = pushes | captures;
+        if constexpr (Type == MoveGenType::NOISY) {
+          pawn_targets = (pushes & promotion_rank) | captures;
+        } else if constexpr (Type == MoveGenType::QUIET) {
+          pawn_targets = pushes & ~promotion_rank;
+        }
+        Piece::AddPawnMoves(moves, src_square, pawn_targets & mask);
+
+        // En passant removes two pawns from the same rank, which can expose
+        // the king along that rank, so it is tested on the resulting board.
+        if ((Type != MoveGenType::QUIET) && m_en_passant.has_value() &&
+            (m_en_passant->rank == Traits::EN_PASSANT_RANK)) {
+          const uint8_t target = SquareIndex(m_en_passant.value());
+          if ((PawnAttacks(Us, src) & SquareBit(target)) != EMPTY_BITBOARD) {
+            const Bitboard captured =
+                SquareBit(SquareIndex(m_en_passant->file, src_square.rank));
+            const Bitboard occupied_after =
+                (occupied ^ bit ^ captured) | SquareBit(target);
+            const Bitboard attackers =
+                AttackersTo(king_index, occupied_after) & enemy & ~captured;
+            if (attackers == EMPTY_BITBOARD) {
+              moves.Add(Move{src_square, m_en_passant.value()});
+            }
+          }
+        }
+        break;
+      }
+      case PieceType::KNIGHT:
+        Piece::AddMoves(moves, src_square,
+                        KNIGHT_ATTACKS[src] & targets & mask);
+        break;
+      case PieceType::BISHOP:
+        Piece::AddMoves(moves, src_square,
+                        BishopAttacks(src, occupied) & targets & mask);
+        break;
+      case PieceType::ROOK:
+        Piece::AddMoves(moves, src_square,
+                        RookAttacks(src, occupied) & targets & mask);
+        break;
+      case PieceType::QUEEN:
+        Piece::AddMoves(moves, src_square,
+                        QueenAttacks(src, occupied) & targets & mask);
+        break;
+      case PieceType::KING:
+        break;
+    }
+  }
+}
+
+template void Board::GenerateLegalMoves<Colour::WHITE>(MoveList& moves) const;
+template void Board::GenerateLegalMoves<Colour::BLACK>(MoveList& moves) const;
+template void Board::GenerateLegalMoves<Colour::WHITE, MoveGenType::NOISY>(
+    MoveList& moves) const;
+template void Board::GenerateLegalMoves<Colour::BLACK, MoveGenType::NOISY>(
+    MoveList& moves) const;
+template void Board::GenerateLegalMoves<Colour::WHITE, MoveGenType::QUIET>(
+    MoveList& moves) const;
+template void Board::GenerateLegalMoves<Colour::BLACK, MoveGenType::QUIET>(
+    MoveList& moves) const;
+
+bool Board::IsNoisyMove(const Move& move) const {
+  return MoveIsPawnPromotion(move) ||
+         !m_position.IsEmpty(SquareIndex(move.dst)) || MoveIsEnPassant(move);
+}
+
+template <Colour Us>
+Bitboard Board::PinnedPieces(
+    uint8_t king_index, Bitboard occupied,
+    std::array<Bitboard, NUM_SQUARES>& pin_rays) const {
+  // A piece is pinned if it is the only piece between the king and an enemy
+  // slider. It can only move along the line of the pin.
+  constexpr Colour them = ColourTraits<Us>::THEM;
+  const Bitboard enemy_queens = m_position.GetPieces(them, PieceType::QUEEN);
+  Bitboard snipers =
+      (RookAttacks(king_index, EMPTY_BITBOARD) &
+       (m_position.GetPieces(them, PieceType::ROOK) | enemy_queens)) |
+      (BishopAttacks(king_index, EMPTY_BITBOARD) &
+       (m_position.GetPieces(them, PieceType::BISHOP) | enemy_queens));
+  Bitboard pinned = EMPTY_BITBOARD;
+  while (snipers != EMPTY_BITBOARD) {
+    const uint8_t sniper = PopLsb(snipers);
+    const Bitboard blockers = BETWEEN_SQUARES[king_index][sniper] & occupied;
+    if ((PopCount(blockers) == 1) &&
+        ((blockers & m_position.GetPieces(Us)) != EMPTY_BITBOARD)) {
+      pinned |= blockers;
+      pin_rays[Lsb(blockers)] =
+          BETWEEN_SQUARES[king_index][sniper] | SquareBit(sniper);
+    }
+  }
+
+  return pinned;
+}
+
+template <Colour Us>
+void Board::GenerateCastles(MoveList& moves) const {
+  if (CanCastle<Us, true>()) {
+    moves.Add(ColourTraits<Us>::KING_CASTLE);
+  }
+  if (CanCastle<Us, false>()) {
+    moves.Add(ColourTraits<Us>::QUEEN_CASTLE);
+  }
+}
+
+Bitboard Board::AttackersTo(uint8_t index, Bitboard occupied) const {
+  const Bitboard queens = m_position.GetPieces(PieceType::QUEEN);
+  return (PawnAttacks(Colour::WHITE, index) &
+          m_position.GetPieces(Colour::BLACK, PieceType::PAWN)) |
+         (PawnAttacks(Colour::BLACK, index) &
+          m_position.GetPieces(Colour::WHITE, PieceType::PAWN)) |
+         (KNIGHT_ATTACKS[index] & m_position.GetPieces(PieceType::KNIGHT)) |
+         (KING_ATTACKS[index] & m_position.GetPieces(PieceType::KING)) |
+         (BishopAttacks(index, occupied) &
+          (m_position.GetPieces(PieceType::BISHOP) | queens)) |
+         (RookAttacks(index, occupied) &
+          (m_position.GetPieces(PieceType::ROOK) | queens));
 }
 
-std::vector<Move> Board::GetMovesFrom(const Square& square) const {
-  // TODO: Handle en passant moves.
-  const Piece* src_piece = PieceAt(square);
-  if (src_piece == nullptr) {
-    return {};
+PackedMove Board::PackMove(const Move& move) const {
+  const uint8_t src = SquareIndex(move.src);
+  const uint8_t dst = SquareIndex(move.dst);
+
+  if (MoveIsPawnPromotion(move)) {
+    return PackedMove(src, dst, PackedMove::Flag::PROMOTION,
+                      move.promotion_type);
+  } else if (MoveIsEnPassant(move)) {
+    return PackedMove(src, dst, PackedMove::Flag::EN_PASSANT);
+  } else if (MoveIsWKC(move) || MoveIsWQC(move) || MoveIsBKC(move) ||
+             MoveIsBQC(move)) {
+    return PackedMove(src, dst, PackedMove::Flag::CASTLING);
   }
 
-  return src_piece->GetMoves(*this);
+  return PackedMove(src, dst);
+}
+
+Colour Board::GetSideToMove() const { return m_side_to_move; }
+
+void Board::SetSideToMove(Colour colour) {
+  m_hash ^= SideKey(m_side_to_move) ^ SideKey(colour);
+  m_side_to_move = colour;
+  m_attack_map_valid = false;
 }
 
 const std::optional<Square>& Board::GetWhiteKing() const {
@@ -295,28 +1081,228 @@ const std::optional<Square>& Board::GetBlackKing() const {
   return m_black_king_square;
 }
 
+const std::optional<Square>& Board::GetEnPassant() const {
+  return m_en_passant;
+}
+
+const Position& Board::GetBitboards() const { return m_position; }
+
+const Board::AttackMap& Board::GetAttackMap() const {
+  if (!m_attack_map_valid) {
+    if (m_side_to_move == Colour::WHITE) {
+      ComputeAttackMap<Colour::WHITE>();
+    } else {
+      ComputeAttackMap<Colour::BLACK>();
+    }
+    m_attack_map_valid = true;
+  }
+  return m_attack_map;
+}
+
+template <Colour Us>
+void Board::ComputeAttackMap() const {
+  constexpr Colour them = ColourTraits<Us>::THEM;
+  const Bitboard occupied = m_position.GetOccupied();
+
+  m_attack_map.attacked[static_cast<uint8_t>(Us)] =
+      AttackedSquares<Us>(occupied);
+  m_attack_map.attacked[static_cast<uint8_t>(them)] =
+      AttackedSquares<them>(occupied);
+  m_attack_map.checkers = EMPTY_BITBOARD;
+  m_attack_map.pinned = EMPTY_BITBOARD;
+
+  const Bitboard king = m_position.GetPieces(Us, PieceType::KING);
+  if (king != EMPTY_BITBOARD) {
+    const uint8_t king_index = Lsb(king);
+    std::array<Bitboard, NUM_SQUARES> pin_rays;
+    m_attack_map.checkers =
+        AttackersTo(king_index, occupied) & m_position.GetPieces(them);
+    m_attack_map.pinned = PinnedPieces<Us>(king_index, occupied, pin_rays);
+  }
+}
+
+template <Colour By>
+Bitboard Board::AttackedSquares(Bitboard occupied) const {
+  Bitboard attacked = EMPTY_BITBOARD;
+  Bitboard pieces = m_position.GetPieces(By);
+  while (pieces != EMPTY_BITBOARD) {
+    const uint8_t index = PopLsb(pieces);
+    switch (m_position.GetType(index)) {
+      case PieceType::PAWN:
+        attacked |= PawnAttacks(By, index);
+        break;
+      case PieceType::KNIGHT:
+        attacked |= KNIGHT_ATTACKS[index];
+        break;
+      case PieceType::BISHOP:
+        attacked |= BishopAttacks(index, occupied);
+        break;
+      case PieceType::ROOK:
+        attacked |= RookAttacks(index, occupied);
+        break;
+      case PieceType::QUEEN:
+        attacked |= QueenAttacks(index, occupied);
+        break;
+      case PieceType::KING:
+        attacked |= KING_ATTACKS[index];
+        break;
+    }
+  }
+
+  return attacked;
+}
+
+bool Board::IsLegalPseudoLegalMove(const Move& move) const {
+  const uint8_t src = SquareIndex(move.src);
+  const uint8_t dst = SquareIndex(move.dst);
+  const Colour them = OppositeColour(m_side_to_move);
+  const Bitboard occupied = m_position.GetOccupied();
+
+  // The king cannot step to an attacked square, nor along the line of a
+  // slider that is checking it. Castling was already checked for attacks.
+  if (m_position.GetType(src) == PieceType::KING) {
+    if ((move.src.file + 2 == move.dst.file) ||
+        (move.dst.file + 2 == move.src.file)) {
+      return true;
+    }
+    return (them == Colour::WHITE)
+               ? !IsAttackedBy<Colour::WHITE>(dst, occupied ^ SquareBit(src))
+               : !IsAttackedBy<Colour::BLACK>(dst, occupied ^ SquareBit(src));
+  }
+
+  const Bitboard king = m_position.GetPieces(m_side_to_move, PieceType::KING);
+  if (king == EMPTY_BITBOARD) {
+    return true;
+  }
+
+  // Only the king square is tested, on the occupancy after the move, so
+  // checks, pins and the two pawns en passant removes from a rank are all
+  // seen without building the attack map. Captured pieces attack no more.
+  const Bitboard captured =
+      MoveIsEnPassant(move)
+          ? SquareBit(SquareIndex(move.dst.file, move.src.rank))
+          : SquareBit(dst);
+  const Bitboard occupied_after =
+      ((occupied ^ SquareBit(src)) & ~captured) | SquareBit(dst);
+  const Bitboard attackers = AttackersTo(Lsb(king), occupied_after) &
+                             m_position.GetPieces(them) & ~captured;
+  return attackers == EMPTY_BITBOARD;
+}
+
 bool Board::IsValidMove(const Move& move, Colour active_colour) const {
-  const chess::Piece* src_piece = PieceAt(move.src);
-  if (src_piece == nullptr) {
+  const PieceCode piece = GetPiece(move.src);
+  if (piece.IsNone()) {
     return false;
   }
 
-  // Can only make moves that don't put yourself in check or prevent being in
-  // check
-  auto future_board = AfterMove(move);
-  const bool will_be_in_check = future_board.IsInCheck(active_colour);
-  if (will_be_in_check) {
+  MoveList valid_moves;
+  GetMovesFrom(move.src, valid_moves);
+  if (!valid_moves.Contains(move)) {
     return false;
   }
 
-  const auto valid_moves = GetMovesFrom(move.src);
-  for (auto& valid_move : valid_moves) {
-    if (valid_move == move) {
-      return true;
+  // Moves of the side to move are checked on their king square. Moves out of
+  // turn are tried on a copy of the board.
+  if ((active_colour == m_side_to_move) &&
+      (piece.GetColour() == m_side_to_move)) {
+    return IsLegalPseudoLegalMove(move);
+  }
+
+  return !AfterMove(move).IsInCheck(active_colour);
+}
+
+[[nodiscard]] bool Board::IsSquareAttacked(const Square& square,
+                                           Colour by) const {
+  return (GetAttackMap().attacked[static_cast<uint8_t>(by)] &
+          SquareBit(SquareIndex(square))) != EMPTY_BITBOARD;
+}
+
+template <Colour By>
+bool Board::IsAttackedBy(uint8_t index, Bitboard occupied) const {
+  // Leapers attack a square if the same piece of the other colour standing on
+  // that square would attack them. The cheap leaper lookups go first.
+  if (((PawnAttacks(ColourTraits<By>::THEM, index) &
+        m_position.GetPieces(By, PieceType::PAWN)) != EMPTY_BITBOARD) ||
+      ((KNIGHT_ATTACKS[index] & m_position.GetPieces(By, PieceType::KNIGHT)) !=
+       EMPTY_BITBOARD) ||
+      ((KING_ATTACKS[index] & m_position.GetPieces(By, PieceType::KING)) !=
+       EMPTY_BITBOARD)) {
+    return true;
+  }
+
+  const Bitboard queens = m_position.GetPieces(By, PieceType::QUEEN);
+  return ((BishopAttacks(index, occupied) &
+           (m_position.GetPieces(By, PieceType::BISHOP) | queens)) !=
+          EMPTY_BITBOARD) ||
+         ((RookAttacks(index, occupied) &
+           (m_position.GetPieces(By, PieceType::ROOK) | queens)) !=
+          EMPTY_BITBOARD);
+}
+
+[[nodiscard]] Bitboard Board::AttackersOf(const Square& square) const {
+  return AttackersTo(SquareIndex(square), m_position.GetOccupied());
+}
+
+int Board::SEE(const Move& move) const {
+  const PieceCode moved = GetPiece(move.src);
+  if (moved.IsNone()) {
+    return 0;
+  }
+
+  const uint8_t dst = SquareIndex(move.dst);
+  Bitboard occupied =
+      m_position.GetOccupied() ^ SquareBit(SquareIndex(move.src));
+
+  // Material won by each capture of the sequence, from the side making it
+  std::array<int, 32> gain;
+  const PieceCode target = GetPiece(move.dst);
+  gain[0] = target.IsNone() ? 0 : target.GetValue();
+  PieceType on_square = moved.GetType();
+  if (MoveIsEnPassant(move)) {
+    gain[0] = PAWN_VALUE;
+    occupied ^= SquareBit(SquareIndex(move.dst.file, move.src.rank));
+  } else if (MoveIsPawnPromotion(move) && (on_square == PieceType::PAWN)) {
+    on_square = move.promotion_type;
+    gain[0] += PieceCode(moved.GetColour(), on_square).GetValue() - PAWN_VALUE;
+  }
+
+  Colour side = OppositeColour(moved.GetColour());
+  Bitboard attackers = AttackersTo(dst, occupied) & occupied;
+  std::size_t depth = 0;
+  while (depth + 1 < gain.size()) {
+    const Bitboard own_attackers = attackers & m_position.GetPieces(side);
+    if (own_attackers == EMPTY_BITBOARD) {
+      break;
+    }
+
+    // Least valuable attacker. The king cannot capture a defended piece.
+    PieceType type = PieceType::PAWN;
+    while ((own_attackers & m_position.GetPieces(type)) == EMPTY_BITBOARD) {
+      type = static_cast<PieceType>(static_cast<uint8_t>(type) + 1);
+    }
+    const Bitboard defenders =
+        attackers & m_position.GetPieces(OppositeColour(side));
+    if ((type == PieceType::KING) && (defenders != EMPTY_BITBOARD)) {
+      break;
     }
+
+    depth++;
+    gain[depth] = PieceCode(side, on_square).GetValue() - gain[depth - 1];
+
+    // Removing the attacker may uncover a slider behind it
+    occupied ^= SquareBit(Lsb(own_attackers & m_position.GetPieces(type)));
+    attackers = AttackersTo(dst, occupied) & occupied;
+    on_square = type;
+    side = OppositeColour(side);
+  }
+
+  // Each side can stop capturing when going on would lose material
+  while (depth > 0) {
+    gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+    depth--;
   }
 
-  return false;
+  return gain[0];
 }
 
 [[nodiscard]] bool Board::CanBeCaptured(const Square& square) const {
@@ -324,39 +1310,25 @@ bool Board::IsValidMove(const Move& move, Colour active_colour) const {
     return false;
   }
 
-  const auto* piece_in_check = PieceAt(square);
-
-  for (uint8_t i = 0; i < 8; ++i) {
-    for (uint8_t j = 0; j < 8; ++j) {
-      const Square src_square{i, j};
-      const auto* src_piece = PieceAt(src_square);
-      if ((piece_in_check == nullptr) || (src_piece == nullptr)) {
-        continue;
-      } else if (src_piece->GetColour() == piece_in_check->GetColour()) {
-        continue;
-      }
-
-      const auto moves =
-          src_piece->GetMoves(*this, Piece::FLAG_EXCLUDE_CASTLES);
-      for (auto& move : moves) {
-        if (move.dst == square) {
-          return true;
-        }
-      }
-    }
+  const uint8_t index = SquareIndex(square);
+  if (m_position.IsEmpty(index)) {
+    return false;
   }
 
-  return false;
+  return IsSquareAttacked(square, OppositeColour(m_position.GetColour(index)));
 }
 
 [[nodiscard]] bool Board::IsInCheck(chess::Colour colour) const {
-  const auto king_square =
-      (colour == Colour::WHITE) ? m_white_king_square : m_black_king_square;
-  if (!king_square.has_value()) {
+  // Only the attackers of the king are needed, not the whole attack map
+  const Bitboard king = m_position.GetPieces(colour, PieceType::KING);
+  if (king == EMPTY_BITBOARD) {
     return false;
   }
 
-  return CanBeCaptured(king_square.value());
+  const Bitboard attackers =
+      AttackersTo(Lsb(king), m_position.GetOccupied()) &
+      m_position.GetPieces(OppositeColour(colour));
+  return attackers != EMPTY_BITBOARD;
 }
 
 [[nodiscard]] Board Board::AfterMove(const Move& move) const {
@@ -365,75 +1337,51 @@ bool Board::IsValidMove(const Move& move, Colour active_colour) const {
   return future_board;
 }
 
-void Board::UpdateCastles() {
-  if (m_white_king_square.has_value()) {
-    const auto* white_king = PieceAt(m_white_king_square.value());
-    const auto* a1 = PieceAt(0, 0);
-    const auto* h1 = PieceAt(7, 0);
-
-    const bool king_not_moved = (white_king != nullptr) &&
-                                (!white_king->HasMoved()) &&
-                                (white_king->GetSquare() == Square{4, 0});
-    const bool a1_not_moved = (a1 != nullptr) && !a1->HasMoved() &&
-                              (a1->GetType() == PieceType::ROOK) &&
-                              (a1->GetColour() == Colour::WHITE);
-    const bool h1_not_moved = (h1 != nullptr) && !h1->HasMoved() &&
-                              (h1->GetType() == PieceType::ROOK) &&
-                              (h1->GetColour() == Colour::WHITE);
-
-    m_wkc = king_not_moved && h1_not_moved;
-    m_wqc = king_not_moved && a1_not_moved;
-  }
-
-  if (m_black_king_square.has_value()) {
-    const auto* black_king = PieceAt(m_black_king_square.value());
-    const auto* a8 = PieceAt(0, 7);
-    const auto* h8 = PieceAt(7, 7);
-
-    const bool king_not_moved = (black_king != nullptr) &&
-                                (!black_king->HasMoved()) &&
-                                (black_king->GetSquare() == Square{4, 7});
-    const bool a8_not_moved = (a8 != nullptr) && !a8->HasMoved() &&
-                              (a8->GetType() == PieceType::ROOK) &&
-                              (a8->GetColour() == Colour::BLACK);
-    const bool h8_not_moved = (h8 != nullptr) && !h8->HasMoved() &&
-                              (h8->GetType() == PieceType::ROOK) &&
-                              (h8->GetColour() == Colour::BLACK);
-
-    m_bkc = king_not_moved && h8_not_moved;
-    m_bqc = king_not_moved && a8_not_moved;
+void Board::UpdateCastles(const Move& move) {
+  // Moving a king or a rook, or capturing a rook, loses the castling rights
+  // that depend on that square.
+  m_hash ^= CastlingKey(m_wkc, m_wqc, m_bkc, m_bqc);
+  for (const Square& square : {move.src, move.dst}) {
+    if (square == Square{4, 0}) {
+      m_wkc = false;
+      m_wqc = false;
+    } else if (square == Square{7, 0}) {
+      m_wkc = false;
+    } else if (square == Square{0, 0}) {
+      m_wqc = false;
+    } else if (square == Square{4, 7}) {
+      m_bkc = false;
+      m_bqc = false;
+    } else if (square == Square{7, 7}) {
+      m_bkc = false;
+    } else if (square == Square{0, 7}) {
+      m_bqc = false;
+    }
   }
+  m_hash ^= CastlingKey(m_wkc, m_wqc, m_bkc, m_bqc);
 }
 
 [[nodiscard]] bool Board::MoveIsWKC(const Move& move) const {
-  const auto* piece = PieceAt(move.src);
-  const bool is_white_king_moving = (piece != nullptr) &&
-                                    (piece->GetType() == PieceType::KING) &&
-                                    (piece->GetColour() == Colour::WHITE);
+  const bool is_white_king_moving =
+      GetPiece(move.src) == PieceCode(Colour::WHITE, PieceType::KING);
   return (is_white_king_moving && (move == WHITE_KING_CASTLE));
 }
 
 [[nodiscard]] bool Board::MoveIsWQC(const Move& move) const {
-  const auto* piece = PieceAt(move.src);
-  const bool is_white_king_moving = (piece != nullptr) &&
-                                    (piece->GetType() == PieceType::KING) &&
-                                    (piece->GetColour() == Colour::WHITE);
+  const bool is_white_king_moving =
+      GetPiece(move.src) == PieceCode(Colour::WHITE, PieceType::KING);
   return (is_white_king_moving && (move == WHITE_QUEEN_CASTLE));
 }
 
 [[nodiscard]] bool Board::MoveIsBKC(const Move& move) const {
-  const auto* piece = PieceAt(move.src);
-  const bool is_black_king_moving = (piece != nullptr) &&
-                                    (piece->GetType() == PieceType::KING) &&
-                                    (piece->GetColour() == Colour::BLACK);
+  const bool is_black_king_moving =
+      GetPiece(move.src) == PieceCode(Colour::BLACK, PieceType::KING);
   return (is_black_king_moving && (move == BLACK_KING_CASTLE));
 }
 
 [[nodiscard]] bool Board::MoveIsBQC(const Move& move) const {
-  const auto* piece = PieceAt(move.src);
-  const bool is_black_king_moving = (piece != nullptr) &&
-                                    (piece->GetType() == PieceType::KING) &&
-                                    (piece->GetColour() == Colour::BLACK);
+  const bool is_black_king_moving =
+      GetPiece(move.src) == PieceCode(Colour::BLACK, PieceType::KING);
   return (is_black_king_moving && (move == BLACK_QUEEN_CASTLE));
 }
 
@@ -450,8 +1398,13 @@ void Board::UpdateCastles() {
 }
 
 [[nodiscard]] bool Board::MoveIsEnPassant(const Move& move) const {
-  (void)move;
-  return false;
+  if (!m_en_passant.has_value() || (move.dst != m_en_passant.value())) {
+    return false;
+  }
+
+  const PieceCode piece = GetPiece(move.src);
+  return !piece.IsNone() && (piece.GetType() == PieceType::PAWN) &&
+         (move.src.file != move.dst.file);
 }
 
 }  // namespace chess
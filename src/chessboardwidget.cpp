@@ -17,10 +17,12 @@
 
 #include "chessboardwidget.h"
 
+#include <QInputDialog>
 #include <QMouseEvent>
 #include <QPainter>
 #include <QRect>
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <functional>
 
@@ -43,83 +45,21 @@ void ChessBoardWidget::Reset() {
   m_active_colour = chess::Colour::WHITE;
 }
 
-static bool IsUpperCase(char ch) {
-  if ((ch >= 'A') && (ch <= 'Z')) {
-    return true;
-  }
-  return false;
-}
-
-static bool IsNumber(char ch) {
-  if ((ch >= '0') && (ch <= '9')) {
-    return true;
-  }
-  return false;
-}
-
-void ChessBoardWidget::SetPosition(const QString& fen_str) {
-  const QStringList& args = fen_str.trimmed().split(" ");
-
-  if (args[1] == 'w') {
-    m_active_colour = chess::Colour::WHITE;
-  } else if (args[1] == 'b') {
-    m_active_colour = chess::Colour::BLACK;
+bool ChessBoardWidget::SetPosition(const QString& fen_str) {
+  chess::Board board;
+  if (!board.FromFEN(fen_str.toStdString()).IsOk()) {
+    return false;
   }
 
-  m_board.Clear();
-
-  const uint32_t move_number = args[5].toUInt();
-  m_half_moves = 2 * (move_number - 1);
+  m_board = board;
+  m_active_colour = m_board.GetSideToMove();
+  m_half_moves = 2 * (m_board.GetFullmoveNumber() - 1);
   if (m_active_colour == chess::Colour::BLACK) {
     m_half_moves++;
   }
 
-  bool wkc = args[2].contains("K");
-  bool wqc = args[2].contains("Q");
-  bool bkc = args[2].contains("k");
-  bool bqc = args[2].contains("q");
-  m_board.SetCastling(wkc, wqc, bkc, bqc);
-
-  const QStringList& lines = args[0].trimmed().split("/");
-  uint8_t i, j;
-  for (j = 0; j < 8; ++j) {
-    i = 0;
-    const QString& line = lines[7 - j];
-
-    for (auto& qch : line) {
-      char ch = qch.toLatin1();
-      if (IsNumber(ch)) {
-        const uint8_t num = ch - '0';
-        i += num;
-      } else {
-        const char piece_char = qch.toLower().toLatin1();
-        const chess::Colour colour =
-            IsUpperCase(ch) ? chess::Colour::WHITE : chess::Colour::BLACK;
-        const chess::PieceType type =
-            chess::GetPieceTypeFromChar(qch.toLower().toLatin1());
-        switch (piece_char) {
-          case 'p':
-          case 'n':
-          case 'b':
-          case 'r':
-          case 'q':
-          case 'k': {
-            std::unique_ptr<chess::Piece> piece =
-                chess::Piece::Factory(type, colour);
-            m_board.SetPiece(std::move(piece), i, j);
-            i++;
-            break;
-          }
-
-          default:
-            i++;
-            break;
-        }
-      }
-    }
-  }
-
   repaint();
+  return true;
 }
 
 void ChessBoardWidget::Rotate() {
@@ -139,6 +79,7 @@ chess::Colour ChessBoardWidget::GetSide() { return m_side; }
 
 void ChessBoardWidget::SetActiveColour(chess::Colour colour) {
   m_active_colour = colour;
+  m_board.SetSideToMove(colour);
 }
 
 chess::Colour ChessBoardWidget::GetActiveColour() const {
@@ -481,7 +422,27 @@ void ChessBoardWidget::SetScoreEnabled(bool enabled) {
   repaint();
 }
 
-bool ChessBoardWidget::DoMove(const chess::Move& move) {
+bool ChessBoardWidget::DoMove(const chess::Move& selected_move) {
+  chess::Move move = selected_move;
+  const chess::Piece* piece = m_board.PieceAt(move.src);
+  if (!move.is_pawn_promotion && (piece != nullptr) &&
+      (piece->GetType() == chess::PieceType::PAWN) &&
+      ((move.dst.rank == 0) || (move.dst.rank == 7))) {
+    // Only ask for the piece once the promotion is known to be valid
+    move.is_pawn_promotion = true;
+    move.promotion_type = chess::PieceType::QUEEN;
+    if (!m_board.IsValidMove(move, m_active_colour)) {
+      return false;
+    }
+
+    const std::optional<chess::PieceType> promotion_type =
+        AskPromotionType();
+    if (!promotion_type.has_value()) {
+      return false;
+    }
+    move.promotion_type = promotion_type.value();
+  }
+
   if (m_board.IsValidMove(move, m_active_colour)) {
     m_board.DoMove(move);
     m_last_move_src_square = move.src;
@@ -496,20 +457,31 @@ bool ChessBoardWidget::DoMove(const chess::Move& move) {
   }
 }
 
+std::optional<chess::PieceType> ChessBoardWidget::AskPromotionType() {
+  const QStringList names{"Queen", "Rook", "Bishop", "Knight"};
+  constexpr std::array<chess::PieceType, 4> TYPES{
+      chess::PieceType::QUEEN, chess::PieceType::ROOK,
+      chess::PieceType::BISHOP, chess::PieceType::KNIGHT};
+
+  bool ok = false;
+  const QString name = QInputDialog::getItem(this, "Promotion", "Promote to:",
+                                             names, 0, false, &ok);
+  const int index = names.indexOf(name);
+  if (!ok || (index < 0)) {
+    return std::nullopt;
+  }
+
+  return TYPES[index];
+}
+
 void ChessBoardWidget::SetSelectableColour(const chess::Colour& colour) {
   m_selectable_colour = colour;
 }
 
 QString ChessBoardWidget::GetFEN() const {
-  const QString board_pos =
-      QString::fromStdString(m_board.GetPosition(m_active_colour));
-  // TODO: Use half moves
-  const QString half_moves = QString::number(0);
-
-  QString fen_str = board_pos + " " + half_moves + " " +
-                    QString::number(1 + (m_half_moves / 2));
-
-  return fen_str;
+  chess::Board::FenBuffer buffer;
+  const std::size_t length = m_board.WriteFEN(buffer);
+  return QString::fromLatin1(buffer.data(), static_cast<qsizetype>(length));
 }
 
 void ChessBoardWidget::SetSelectable(bool selectable) {
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "magic.hpp"
+
+#include "attacks.hpp"
+
+namespace chess {
+
+namespace magic {
+
+std::array<Magic, NUM_SQUARES> rook_magics;
+std::array<Magic, NUM_SQUARES> bishop_magics;
+bool use_pext = false;
+
+}  // namespace magic
+
+namespace {
+
+constexpr std::size_t ROOK_TABLE_SIZE = 102400;
+constexpr std::size_t BISHOP_TABLE_SIZE = 5248;
+
+std::array<Bitboard, ROOK_TABLE_SIZE> rook_table;
+std::array<Bitboard, BISHOP_TABLE_SIZE> bishop_table;
+
+// Multipliers found offline by random search. Each one maps every relevant
+// occupancy of its square to a table slot without destructive collisions.
+constexpr std::array<Bitboard, NUM_SQUARES> ROOK_MAGIC_NUMBERS{
+    0x1080004008801020ULL, 0x0840092002C03000ULL, 0x1900200010400900ULL,
+    0x0880100008000480ULL, 0x4200100420080200ULL, 0x8100020100080400ULL,
+    0x0200040110886200ULL, 0x0200008040220411ULL, 0x0404800084400220ULL,
+    0x0000401000402000ULL, 0x0086001081220440ULL, 0x0408800800100280ULL,
+    0x000A001201040820ULL, 0x8848800200840080ULL, 0x4001000100040200ULL,
+    0x0442000102105084ULL, 0x9080010020804100ULL, 0x0040404000201009ULL,
+    0x0000808010002009ULL, 0x2200090021D00100ULL, 0x0008008008040080ULL,
+    0x0004004002010040ULL, 0x0011040008015042ULL, 0x00000A0001768104ULL,
+    0x0000800080204009ULL, 0x2010004140002001ULL, 0x9800200280100080ULL,
+    0x1000100080080080ULL, 0x0442000A00049020ULL, 0x2100040080020080ULL,
+    0x0800120400900148ULL, 0x0010040A00128541ULL, 0x2800804000800030ULL,
+    0x1010002000400041ULL, 0x4000200011004100ULL, 0x0610008410800800ULL,
+    0x0400802402800800ULL, 0xC100020080800400ULL, 0x0002000802000401ULL,
+    0x0182085882000401ULL, 0x0220204000808000ULL, 0x2860100040024022ULL,
+    0x0001002004110040ULL, 0x99101042000A0020ULL, 0x0004080004008080ULL,
+    0x0010040002008080ULL, 0x2012004881020004ULL, 0x8300842444820011ULL,
+    0x0088403882010200ULL, 0x0820400080210100ULL, 0x0110910040A00300ULL,
+    0x0801100280080480ULL, 0x0242009008200600ULL, 0x1002000489500200ULL,
+    0x0040800200010080ULL, 0x0091800041000080ULL, 0x0000209300488001ULL,
+    0x04C1002414824001ULL, 0x020020000B001041ULL, 0x7000100004200901ULL,
+    0x8002002004100802ULL, 0x30010002084C0007ULL, 0x0888221800813004ULL,
+    0x4000002840840112ULL};
+
+constexpr std::array<Bitboard, NUM_SQUARES> BISHOP_MAGIC_NUMBERS{
+    0xA010041108003100ULL, 0x006082020A002900ULL, 0x6810010619200000ULL,
+    0x08281A0520000408ULL, 0x0001104001000400ULL, 0x0018901008048400ULL,
+    0x00040A0210245280ULL, 0x000200210808A402ULL, 0x9140048410821200ULL,
+    0x0800091010820041ULL, 0x20504804832202C0ULL, 0x0100091401081000ULL,
+    0x8021011140000012ULL, 0x0810020804450400ULL, 0x208B0542109008A2ULL,
+    0x0080084A08040204ULL, 0x0040E2A80811244CULL, 0x2505022008008108ULL,
+    0x0430220100420040ULL, 0x010A040420220040ULL, 0x1105000290400000ULL,
+    0x0093001200822120ULL, 0x4000A62048043004ULL, 0x280120048A015004ULL,
+    0x006090002A020814ULL, 0x44042000240800D0ULL, 0x01102800040A4400ULL,
+    0x1004080080220040ULL, 0x0001001011004024ULL, 0x0010044000805040ULL,
+    0x0914041200820100ULL, 0x0004821012821480ULL, 0x0024040500C05021ULL,
+    0x0088611002080200ULL, 0x0116080A00040020ULL, 0x4000020080080080ULL,
+    0x2450450140840040ULL, 0x0000880201484100ULL, 0x0222020404020092ULL,
+    0x8081110600002E00ULL, 0x2842101105000801ULL, 0x1100809008001025ULL,
+    0x00020202221C0400ULL, 0x0422014022009020ULL, 0x0210046102100C00ULL,
+    0xC004008082029102ULL, 0x00AA461801101200ULL, 0x0404080080201108ULL,
+    0x020542108C205002ULL, 0x0410544804100100ULL, 0x0040910841100000ULL,
+    0x0400200042021100ULL, 0x00004204850400C0ULL, 0x0200100410A42102ULL,
+    0x1040020801210102ULL, 0x0805040410420000ULL, 0x2884804130100200ULL,
+    0x800C262201242000ULL, 0x1058000194108800ULL, 0x0014221054420204ULL,
+    0x0104000012A02200ULL, 0x0200881003300100ULL, 0x0140400202840100ULL,
+    0x0402020801010201ULL};
+
+constexpr std::array<Offset, 4> ROOK_DIRECTIONS{
+    {{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+constexpr std::array<Offset, 4> BISHOP_DIRECTIONS{
+    {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
+
+/**
+ * @brief Walk the rays from a square one step at a time. Only used to fill the
+ * tables.
+ *
+ * @param exclude_edges Leave out the last square of each ray, which never
+ * blocks anything.
+ */
+Bitboard RayAttacks(uint8_t index, Bitboard occupied,
+                    const std::array<Offset, 4>& directions,
+                    bool exclude_edges) {
+  Bitboard attacks = EMPTY_BITBOARD;
+  const Square square = IndexToSquare(index);
+
+  for (const Offset& direction : directions) {
+    int file = square.file + direction.file;
+    int rank = square.rank + direction.rank;
+    while ((file >= 0) && (file < 8) && (rank >= 0) && (rank < 8)) {
+      const int next_file = file + direction.file;
+      const int next_rank = rank + direction.rank;
+      const bool is_edge = (next_file < 0) || (next_file > 7) ||
+                           (next_rank < 0) || (next_rank > 7);
+      if (exclude_edges && is_edge) {
+        break;
+      }
+
+      const Bitboard bit = SquareBit(
+          SquareIndex(static_cast<uint8_t>(file), static_cast<uint8_t>(rank)));
+      attacks |= bit;
+      if ((occupied & bit) != EMPTY_BITBOARD) {
+        break;
+      }
+
+      file = next_file;
+      rank = next_rank;
+    }
+  }
+
+  return attacks;
+}
+
+void InitMagics(std::array<magic::Magic, NUM_SQUARES>& magics,
+                Bitboard* table,
+                const std::array<Bitboard, NUM_SQUARES>& magic_numbers,
+                const std::array<Offset, 4>& directions) {
+  Bitboard* attacks = table;
+
+  for (uint8_t index = 0; index < NUM_SQUARES; ++index) {
+    magic::Magic& entry = magics[index];
+    entry.mask = RayAttacks(index, EMPTY_BITBOARD, directions, true);
+    entry.magic = magic_numbers[index];
+    entry.shift = 64 - PopCount(entry.mask);
+    entry.attacks = attacks;
+
+    // Enumerate all subsets of the mask (Carry-Rippler)
+    Bitboard occupied = EMPTY_BITBOARD;
+    do {
+      attacks[magic::Index(entry, occupied)] =
+          RayAttacks(index, occupied, directions, false);
+      occupied = (occupied - entry.mask) & entry.mask;
+    } while (occupied != EMPTY_BITBOARD);
+
+    attacks += (Bitboard{1} << PopCount(entry.mask));
+  }
+}
+
+const bool initialised = (InitSlidingAttacks(), true);
+
+}  // namespace
+
+void InitSlidingAttacks(bool allow_pext) {
+#ifdef CHESS_PEXT_AVAILABLE
+  magic::use_pext = allow_pext && __builtin_cpu_supports("bmi2");
+#else
+  (void)allow_pext;
+  magic::use_pext = false;
+#endif
+
+  InitMagics(magic::rook_magics, rook_table.data(), ROOK_MAGIC_NUMBERS,
+             ROOK_DIRECTIONS);
+  InitMagics(magic::bishop_magics, bishop_table.data(), BISHOP_MAGIC_NUMBERS,
+             BISHOP_DIRECTIONS);
+}
+
+bool IsUsingPext() { return magic::use_pext; }
+
+}  // namespace chess
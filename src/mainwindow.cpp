@@ -39,12 +39,15 @@ MainWindow::MainWindow(QWidget* parent)
   Init();
   connect(&m_engine, &UCIEngine::DepthInfoAvailable, this,
           &MainWindow::OnDepthInfoAvailable);
+  connect(&m_native_engine, &NativeEngine::DepthInfoAvailable, this,
+          &MainWindow::OnDepthInfoAvailable);
   connect(m_board, &ChessBoardWidget::MoveDone, this, &MainWindow::OnMoveDone);
 }
 
 MainWindow::~MainWindow() {
   delete ui;
   m_engine.Close();
+  m_native_engine.Stop();
 }
 
 void MainWindow::Init() {
@@ -78,6 +81,7 @@ void MainWindow::Init() {
       QString("Number of CPU threads to use.\nMaximum number of threads: " +
               QString::number(max_num_threads)));
   m_engine.SetNumThreads(initial_threads);
+  m_native_engine.SetNumThreads(initial_threads);
   ui->sbThreads->setValue(initial_threads);
 
   NewGame();
@@ -93,6 +97,7 @@ void MainWindow::NewGame() {
   m_moves_list.clear();
   ResetPosition(QString::fromStdString(chess::STARTPOS_FEN));
   m_engine.NewGame();
+  m_native_engine.NewGame();
   m_board->SetSelectableColour(chess::Colour::WHITE);
 }
 
@@ -109,8 +114,20 @@ void MainWindow::SetDepth(uint8_t depth) {
 
 void MainWindow::RestartSearch() {
   if (ui->bEngineOn->isChecked()) {
-    m_engine.Stop();
-    const bool infinite_search = ui->chInfinite->isChecked();
+    StopSearch();
+    StartSearch();
+  }
+}
+
+void MainWindow::StartSearch() {
+  const bool infinite_search = ui->chInfinite->isChecked();
+  if (m_use_native_engine) {
+    if (infinite_search) {
+      m_native_engine.SearchInfinite();
+    } else {
+      m_native_engine.SearchWithDepth(m_depth);
+    }
+  } else {
     if (infinite_search) {
       m_engine.SearchInfinite();
     } else {
@@ -119,29 +136,31 @@ void MainWindow::RestartSearch() {
   }
 }
 
-bool MainWindow::ResetPosition(const QString& fen_str) {
-  if (fen_str.isEmpty()) {
-    return false;
+void MainWindow::StopSearch() {
+  if (m_use_native_engine) {
+    m_native_engine.Stop();
+  } else {
+    m_engine.Stop();
   }
+}
 
-  const char* FEN_SEPARATOR = " ";
-  QStringList args = fen_str.trimmed().split(FEN_SEPARATOR);
-  for (auto& arg : args) {
-    arg = arg.trimmed();
-  }
+void MainWindow::SetEnginePosition(const QString& fen_str) {
+  m_engine.SetPosition(fen_str);
+  m_native_engine.SetPosition(fen_str);
+}
 
-  if (args.length() != 6) {
+bool MainWindow::ResetPosition(const QString& fen_str) {
+  if (!m_board->SetPosition(fen_str.trimmed())) {
     return false;
   }
 
-  m_board->SetPosition(fen_str);
   const auto active_colour = m_board->GetActiveColour();
   m_board->SetSelectableColour(active_colour);
 
   m_moves_list.clear();
   ui->teMoves->clear();
 
-  m_engine.SetPosition(fen_str);
+  SetEnginePosition(fen_str);
   RestartSearch();
 
   return true;
@@ -159,7 +178,7 @@ void MainWindow::OnMoveDone(const chess::Move& move) {
   UpdateMoveList();
 
   QString fen_str = m_board->GetFEN();
-  m_engine.SetPosition(fen_str);
+  SetEnginePosition(fen_str);
   RestartSearch();
 }
 
@@ -190,7 +209,9 @@ int MainWindow::GetColourScore(chess::Colour colour, int score) const {
 
 void MainWindow::OnDepthInfoAvailable() {
   ui->teLines->clear();
-  std::vector<UCIEngine::DepthInfo> lines = m_engine.GetLines();
+  std::vector<UCIEngine::DepthInfo> lines = m_use_native_engine
+                                                ? m_native_engine.GetLines()
+                                                : m_engine.GetLines();
   const auto colour = m_board->GetActiveColour();
 
   for (uint32_t i = 0; i < lines.size(); ++i) {
@@ -263,15 +284,10 @@ void MainWindow::UpdateMoveList() {
 void MainWindow::SetEngineEnabled(bool enabled) {
   if (enabled) {
     ui->bEngineOn->setPalette(QColor(Qt::green));
-    const bool infinite_search = ui->chInfinite->isChecked();
-    if (infinite_search) {
-      m_engine.SearchInfinite();
-    } else {
-      m_engine.SearchWithDepth(m_depth);
-    }
+    StartSearch();
   } else {
     ui->bEngineOn->setPalette(QColor(Qt::red));
-    m_engine.Stop();
+    StopSearch();
     ui->teLines->clear();
   }
 
@@ -308,6 +324,12 @@ void MainWindow::on_chInfinite_toggled(bool checked) {
 void MainWindow::on_sbThreads_editingFinished() {
   const int threads = ui->sbThreads->value();
   m_engine.SetNumThreads(threads);
+
+  // The internal search stops to change its threads
+  m_native_engine.SetNumThreads(threads);
+  if (m_use_native_engine) {
+    RestartSearch();
+  }
 }
 
 void MainWindow::on_sbLines_editingFinished() {
@@ -354,6 +376,13 @@ void MainWindow::on_bSettings_clicked() { m_settings_dialog->exec(); }
 void MainWindow::on_actionRestart_triggered() {
   m_engine.Reset();
   const QString fen = m_board->GetFEN();
-  m_engine.SetPosition(fen);
+  SetEnginePosition(fen);
+  RestartSearch();
+}
+
+void MainWindow::on_actionInternal_engine_toggled(bool checked) {
+  StopSearch();
+  m_use_native_engine = checked;
+  ui->teLines->clear();
   RestartSearch();
 }
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "movepicker.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+
+namespace chess {
+
+namespace {
+
+// Quiet moves known to have refuted other moves go before the history moves
+constexpr int FIRST_KILLER_SCORE = 3 * MoveHistory::MAX_SCORE;
+constexpr int SECOND_KILLER_SCORE = FIRST_KILLER_SCORE - 1;
+constexpr int COUNTER_MOVE_SCORE = 2 * MoveHistory::MAX_SCORE;
+
+/**
+ * @brief Value of a piece for ordering captures. The king counts as the
+ * least valuable attacker: a legal king capture cannot be recaptured.
+ */
+constexpr int OrderingValue(PieceType type) {
+  constexpr std::array<uint8_t, 6> VALUES{
+      PAWN_VALUE, KNIGHT_VALUE, BISHOP_VALUE, ROOK_VALUE, QUEEN_VALUE, 0};
+  return VALUES[static_cast<uint8_t>(type)];
+}
+
+}  // namespace
+
+void MoveHistory::Clear() {
+  for (auto& side_scores : m_scores) {
+    for (auto& src_scores : side_scores) {
+      src_scores.fill(0);
+    }
+  }
+  for (auto& src_moves : m_counter_moves) {
+    src_moves.fill(PackedMove());
+  }
+}
+
+void MoveHistory::AddCutoff(Colour side, PackedMove previous, PackedMove move,
+                            uint8_t depth) {
+  Update(side, move, depth * depth);
+  if (!previous.IsNull()) {
+    m_counter_moves[previous.GetSrc()][previous.GetDst()] = move;
+  }
+}
+
+void MoveHistory::AddFailure(Colour side, PackedMove move, uint8_t depth) {
+  Update(side, move, -(depth * depth));
+}
+
+void MoveHistory::Update(Colour side, PackedMove move, int bonus) {
+  // The score moves towards the bound by a fraction of the distance left, so
+  // it saturates instead of overflowing and recent results weigh more.
+  bonus = std::clamp(bonus, -MAX_SCORE, MAX_SCORE);
+  int16_t& score =
+      m_scores[static_cast<uint8_t>(side)][move.GetSrc()][move.GetDst()];
+  score = static_cast<int16_t>(score + bonus -
+                               (score * std::abs(bonus) / MAX_SCORE));
+}
+
+MovePicker::MovePicker(const Board& board, PackedMove hash_move,
+                       const Killers& killers, PackedMove counter_move,
+                       const MoveHistory& history)
+    : m_board(board),
+      m_killers(&killers),
+      m_counter_move(counter_move),
+      m_history(&history) {
+  if (hash_move.IsNull()) {
+    return;
+  }
+
+  const Move move = hash_move.ToMove();
+  const PieceCode piece = board.GetPiece(move.src);
+  if (!piece.IsNone() && (piece.GetColour() == board.GetSideToMove()) &&
+      board.IsValidMove(move, board.GetSideToMove())) {
+    m_hash_move = move;
+  }
+}
+
+MovePicker::MovePicker(const Board& board)
+    : m_board(board), m_stage(Stage::GENERATE_NOISY) {}
+
+std::optional<Move> MovePicker::Next() {
+  while (true) {
+    switch (m_stage) {
+      case Stage::HASH_MOVE:
+        m_stage = Stage::GENERATE_NOISY;
+        if (m_hash_move.has_value()) {
+          return m_hash_move;
+        }
+        break;
+
+      case Stage::GENERATE_NOISY:
+        m_board.GenerateLegalMoves(m_moves, MoveGenType::NOISY);
+        ScoreNoisyMoves();
+        m_stage = Stage::NOISY;
+        break;
+
+      case Stage::GENERATE_QUIET:
+        m_moves.Clear();
+        m_next = 0;
+        m_board.GenerateLegalMoves(m_moves, MoveGenType::QUIET);
+        ScoreQuietMoves();
+        m_stage = Stage::QUIET;
+        break;
+
+      case Stage::NOISY:
+      case Stage::QUIET:
+        while (m_next < m_moves.Size()) {
+          const Move& move = PickBest();
+          if (move != m_hash_move) {
+            return move;
+          }
+        }
+        m_stage = ((m_stage == Stage::NOISY) && (m_history != nullptr))
+                      ? Stage::GENERATE_QUIET
+                      : Stage::DONE;
+        break;
+
+      case Stage::DONE:
+        return std::nullopt;
+    }
+  }
+}
+
+void MovePicker::ScoreNoisyMoves() {
+  for (std::size_t i = 0; i < m_moves.Size(); ++i) {
+    const Move& move = m_moves[i];
+    const PieceCode attacker = m_board.GetPiece(move.src);
+    const PieceCode victim = m_board.GetPiece(move.dst);
+
+    // En passant captures a pawn on another square
+    int gain = victim.IsNone() ? 0 : OrderingValue(victim.GetType());
+    if (victim.IsNone() && (move.src.file != move.dst.file)) {
+      gain = OrderingValue(PieceType::PAWN);
+    }
+    if (move.is_pawn_promotion) {
+      gain += OrderingValue(move.promotion_type) - PAWN_VALUE;
+    }
+
+    // Most valuable victim first, then least valuable attacker
+    m_scores[i] = (16 * gain) - OrderingValue(attacker.GetType());
+  }
+}
+
+void MovePicker::ScoreQuietMoves() {
+  const Colour side = m_board.GetSideToMove();
+  for (std::size_t i = 0; i < m_moves.Size(); ++i) {
+    const PackedMove move(m_moves[i]);
+    if (move == (*m_killers)[0]) {
+      m_scores[i] = FIRST_KILLER_SCORE;
+    } else if (move == (*m_killers)[1]) {
+      m_scores[i] = SECOND_KILLER_SCORE;
+    } else if (move == m_counter_move) {
+      m_scores[i] = COUNTER_MOVE_SCORE;
+    } else {
+      m_scores[i] = m_history->GetScore(side, move);
+    }
+  }
+}
+
+const Move& MovePicker::PickBest() {
+  std::size_t best = m_next;
+  for (std::size_t i = m_next + 1; i < m_moves.Size(); ++i) {
+    if (m_scores[i] > m_scores[best]) {
+      best = i;
+    }
+  }
+  std::swap(m_moves[m_next], m_moves[best]);
+  std::swap(m_scores[m_next], m_scores[best]);
+
+  return m_moves[m_next++];
+}
+
+}  // namespace chess
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "nativeengine.hpp"
+
+NativeEngine::NativeEngine() {
+  m_search.SetInfoCallback(
+      [this](const chess::SearchInfo& info) { OnSearchInfo(info); });
+}
+
+NativeEngine::~NativeEngine() { Stop(); }
+
+void NativeEngine::NewGame() {
+  Stop();
+  m_search.ClearHash();
+}
+
+void NativeEngine::SetPosition(const QString& fen) {
+  Stop();
+  m_has_position = m_board.SetPosition(fen.toStdString());
+}
+
+void NativeEngine::Stop() {
+  if (m_search_thread.joinable()) {
+    m_search.Stop();
+    m_search_thread.join();
+  }
+}
+
+void NativeEngine::SearchWithDepth(uint8_t depth) {
+  StartSearch({depth, 0});
+}
+
+void NativeEngine::SearchInfinite() { StartSearch({chess::MAX_PLY, 0}); }
+
+void NativeEngine::SetNumThreads(uint16_t num_threads) {
+  // The search cannot change its threads while it runs
+  Stop();
+  m_search.SetNumThreads(num_threads);
+}
+
+std::vector<UCIEngine::DepthInfo> NativeEngine::GetLines() {
+  std::lock_guard<std::mutex> mutex(m_info_mutex);
+  return m_lines;
+}
+
+void NativeEngine::StartSearch(const chess::SearchLimits& limits) {
+  Stop();
+  {
+    std::lock_guard<std::mutex> mutex(m_info_mutex);
+    m_lines.clear();
+  }
+  if (!m_has_position) {
+    return;
+  }
+
+  // The board is not changed until the search is stopped and joined. A stop
+  // sent after the last search finished must not stop this one.
+  m_search.ClearStop();
+  m_search_thread =
+      std::thread([this, limits] { m_search.Run(m_board, limits); });
+}
+
+void NativeEngine::OnSearchInfo(const chess::SearchInfo& info) {
+  // Runs in the search thread. The signal is queued to the receivers' thread.
+  UCIEngine::DepthInfo depth_info;
+  depth_info.line_id = 1;
+  depth_info.depth = info.depth;
+  depth_info.mate_counter = info.mate_counter;
+  depth_info.score = info.score;
+  for (const chess::Move& move : info.pv) {
+    depth_info.pv.push_back(QString::fromStdString(chess::MoveToUCI(move)));
+  }
+
+  {
+    std::lock_guard<std::mutex> mutex(m_info_mutex);
+    m_lines = {depth_info};
+  }
+  emit DepthInfoAvailable();
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "perft.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <optional>
+
+#include "movelist.hpp"
+#include "threadpool.hpp"
+
+namespace chess {
+
+namespace {
+
+/**
+ * @brief Perft, making and unmaking the moves with a history kept for the
+ * whole tree.
+ */
+uint64_t CountNodes(Board& board, BoardHistory& history, uint8_t depth,
+                    PerftTable* table) {
+  if (depth == 0) {
+    return 1;
+  }
+
+  MoveList moves;
+  board.GenerateLegalMoves(moves);
+
+  // The moves are legal, so the leaves do not need to be played
+  if (depth == 1) {
+    return moves.Size();
+  }
+
+  uint64_t nodes = 0;
+  if ((table != nullptr) && table->Probe(board.Hash(), depth, &nodes)) {
+    return nodes;
+  }
+
+  for (const Move& move : moves) {
+    board.MakeMove(move, history);
+    nodes += CountNodes(board, history, depth - 1, table);
+    board.UnmakeMove(history);
+  }
+
+  if (table != nullptr) {
+    table->Store(board.Hash(), depth, nodes);
+  }
+
+  return nodes;
+}
+
+}  // namespace
+
+PerftTable::PerftTable(std::size_t size_mb) {
+  const std::size_t size =
+      std::bit_floor(std::max<std::size_t>(1, (size_mb << 20) / sizeof(Entry)));
+  m_entries = std::make_unique<Entry[]>(size);
+  m_mask = size - 1;
+}
+
+bool PerftTable::Probe(uint64_t hash, uint8_t depth, uint64_t* nodes) const {
+  const Entry& entry = m_entries[hash & m_mask];
+  const uint64_t data = entry.data.load(std::memory_order_relaxed);
+  const uint64_t key = entry.key.load(std::memory_order_relaxed);
+  if (((key ^ data) != hash) || ((data & 0xFF) != depth)) {
+    return false;
+  }
+
+  *nodes = data >> 8;
+  return true;
+}
+
+void PerftTable::Store(uint64_t hash, uint8_t depth, uint64_t nodes) {
+  Entry& entry = m_entries[hash & m_mask];
+  const uint64_t data = (nodes << 8) | depth;
+  entry.key.store(hash ^ data, std::memory_order_relaxed);
+  entry.data.store(data, std::memory_order_relaxed);
+}
+
+uint64_t Perft(Board& board, uint8_t depth, PerftTable* table) {
+  BoardHistory history;
+  return CountNodes(board, history, depth, table);
+}
+
+std::vector<PerftDivideEntry> PerftDivide(Board& board, uint8_t depth) {
+  std::vector<PerftDivideEntry> entries;
+  if (depth == 0) {
+    return entries;
+  }
+
+  MoveList moves;
+  board.GenerateLegalMoves(moves);
+  entries.reserve(moves.Size());
+  BoardHistory history;
+  for (const Move& move : moves) {
+    board.MakeMove(move, history);
+    entries.push_back({move, CountNodes(board, history, depth - 1, nullptr)});
+    board.UnmakeMove(history);
+  }
+
+  return entries;
+}
+
+std::vector<PerftDivideEntry> ParallelPerftDivide(const Board& board,
+                                                  uint8_t depth,
+                                                  std::size_t num_threads,
+                                                  PerftTable* table) {
+  std::vector<PerftDivideEntry> entries;
+  if (depth == 0) {
+    return entries;
+  }
+
+  MoveList moves;
+  board.GenerateLegalMoves(moves);
+  std::vector<std::atomic<uint64_t>> counts(moves.Size());
+
+  {
+    ThreadPool pool(num_threads);
+
+    // Each task plays its moves on its own copy of the board. The moves
+    // leading to a subtree are never taken back.
+    const auto count_subtree = [&](std::size_t root,
+                                   std::optional<Move> reply) {
+      pool.Submit([&board, &moves, &counts, table, depth, root, reply] {
+        Board child = board;
+        child.DoMove(moves[root]);
+        uint8_t subtree_depth = depth - 1;
+        if (reply.has_value()) {
+          child.DoMove(reply.value());
+          subtree_depth--;
+        }
+        counts[root] += Perft(child, subtree_depth, table);
+      });
+    };
+
+    for (std::size_t i = 0; i < moves.Size(); ++i) {
+      // A few dozen root moves are too coarse to balance the threads, so deep
+      // trees are split at the replies too.
+      if (depth < 3) {
+        count_subtree(i, std::nullopt);
+        continue;
+      }
+
+      Board after_root = board;
+      after_root.DoMove(moves[i]);
+      MoveList replies;
+      after_root.GenerateLegalMoves(replies);
+      for (const Move& reply : replies) {
+        count_subtree(i, reply);
+      }
+    }
+
+    pool.Wait();
+  }
+
+  entries.reserve(moves.Size());
+  for (std::size_t i = 0; i < moves.Size(); ++i) {
+    entries.push_back({moves[i], counts[i].load()});
+  }
+
+  return entries;
+}
+
+}  // namespace chess
@@ -17,376 +17,176 @@
 
 #include "piece.hpp"
 
-namespace chess {
+#include "attacks.hpp"
+#include "magic.hpp"
 
-Piece::Piece(Colour colour, PieceType type, uint8_t value)
-    : m_colour(colour), m_type(type), m_value(value) {}
+namespace chess {
 
-[[nodiscard]] std::unique_ptr<Piece> Piece::Factory(PieceType type,
-                                                    Colour colour) {
-  switch (type) {
-    default:
-    case PieceType::PAWN:
-      return std::make_unique<Pawn>(colour);
-    case PieceType::KNIGHT:
-      return std::make_unique<Knight>(colour);
-    case PieceType::BISHOP:
-      return std::make_unique<Bishop>(colour);
-    case PieceType::ROOK:
-      return std::make_unique<Rook>(colour);
-    case PieceType::QUEEN:
-      return std::make_unique<Queen>(colour);
-    case PieceType::KING:
-      return std::make_unique<King>(colour);
+namespace {
+
+template <Colour C>
+void GetPawnMoves(const Board& board, const Square& square, MoveList& moves) {
+  using Traits = ColourTraits<C>;
+  const Position& position = board.GetBitboards();
+  const uint8_t index = SquareIndex(square);
+  const Bitboard empty = ~position.GetOccupied();
+
+  // Shifting a bit off the board leaves an empty set, so no bounds checks are
+  // needed.
+  const Bitboard single_push = PawnPush<C>(SquareBit(index)) & empty;
+  Bitboard pushes = single_push;
+  if (square.rank == Traits::PAWN_START_RANK) {
+    pushes |= PawnPush<C>(single_push) & empty;
   }
-}
-
-[[nodiscard]] Colour Piece::GetColour() const { return m_colour; }
-
-[[nodiscard]] PieceType Piece::GetType() const { return m_type; }
-
-[[nodiscard]] uint8_t Piece::GetValue() const { return m_value; }
 
-[[nodiscard]] Square Piece::GetSquare() const { return m_square; }
+  // En passant targets are only reachable from the fifth rank of each side.
+  Bitboard capture_targets = position.GetPieces(Traits::THEM);
+  const auto& en_passant = board.GetEnPassant();
+  if (en_passant.has_value() && (en_passant->rank == Traits::EN_PASSANT_RANK)) {
+    capture_targets |= SquareBit(SquareIndex(en_passant.value()));
+  }
+  const Bitboard captures = PawnAttacks(C, index) & capture_targets;
 
-void Piece::SetSquare(const Square& square) { m_square = square; }
+  Piece::AddPawnMoves(moves, square, pushes | captures);
+}
 
-[[nodiscard]] bool Piece::HasMoved() const { return m_has_moved; }
+template <Colour C>
+void GetCastles(const Board& board, MoveList& moves) {
+  const bool can_king_castle =
+      (C == Colour::WHITE) ? board.CanWKC() : board.CanBKC();
+  const bool can_queen_castle =
+      (C == Colour::WHITE) ? board.CanWQC() : board.CanBQC();
+  if (can_king_castle) {
+    moves.Add(ColourTraits<C>::KING_CASTLE);
+  }
+  if (can_queen_castle) {
+    moves.Add(ColourTraits<C>::QUEEN_CASTLE);
+  }
+}
 
-void Piece::SetMoved(bool moved) { m_has_moved = moved; }
+}  // namespace
 
-[[nodiscard]] std::vector<Move> Piece::GetSlidingMoves(
-    const Board& board, Direction direction) const {
-  std::vector<Move> moves;
+template <Colour C>
+void GetPieceMoves(const Board& board, PieceType type, const Square& square,
+                   MoveList& moves, uint32_t flags) {
+  const Position& position = board.GetBitboards();
+  const uint8_t index = SquareIndex(square);
+  const Bitboard own = position.GetPieces(C);
 
-  for (uint8_t n = 1; n < 8; ++n) {
-    const Square dst_square = GetSquareInDirection(direction, n, m_square);
-    if (!IsValidSquare(dst_square)) {
+  switch (type) {
+    case PieceType::PAWN:
+      GetPawnMoves<C>(board, square, moves);
       break;
-    }
-    const chess::Move move{m_square, dst_square};
-    const auto* dst_piece = board.PieceAt(dst_square);
-    if (dst_piece == nullptr) {
-      moves.push_back(move);
-    } else {
-      if (dst_piece->GetColour() != m_colour) {
-        moves.push_back(move);
+    case PieceType::KNIGHT:
+      Piece::AddMoves(moves, square, KNIGHT_ATTACKS[index] & ~own);
+      break;
+    case PieceType::BISHOP:
+      Piece::AddMoves(moves, square,
+                      BishopAttacks(index, position.GetOccupied()) & ~own);
+      break;
+    case PieceType::ROOK:
+      Piece::AddMoves(moves, square,
+                      RookAttacks(index, position.GetOccupied()) & ~own);
+      break;
+    case PieceType::QUEEN:
+      Piece::AddMoves(moves, square,
+                      QueenAttacks(index, position.GetOccupied()) & ~own);
+      break;
+    case PieceType::KING:
+      Piece::AddMoves(moves, square, KING_ATTACKS[index] & ~own);
+      if ((flags & Piece::FLAG_EXCLUDE_CASTLES) == 0) {
+        GetCastles<C>(board, moves);
       }
       break;
-    }
   }
-
-  return moves;
-}
-
-// PAWN
-Pawn::Pawn(Colour colour) : Piece(colour, PieceType::PAWN, PAWN_VALUE) {}
-
-[[nodiscard]] std::unique_ptr<Piece> Pawn::Clone() const {
-  return std::unique_ptr<Piece>(new Pawn(*this));
 }
 
-[[nodiscard]] char Pawn::GetFenChar() const {
-  if (m_colour == Colour::WHITE) {
-    return 'P';
+template void GetPieceMoves<Colour::WHITE>(const Board& board, PieceType type,
+                                           const Square& square,
+                                           MoveList& moves, uint32_t flags);
+template void GetPieceMoves<Colour::BLACK>(const Board& board, PieceType type,
+                                           const Square& square,
+                                           MoveList& moves, uint32_t flags);
+
+void GetPieceMoves(const Board& board, PieceCode piece, const Square& square,
+                   MoveList& moves, uint32_t flags) {
+  if (piece.GetColour() == Colour::WHITE) {
+    GetPieceMoves<Colour::WHITE>(board, piece.GetType(), square, moves, flags);
   } else {
-    return 'p';
+    GetPieceMoves<Colour::BLACK>(board, piece.GetType(), square, moves, flags);
   }
 }
 
-[[nodiscard]] std::vector<Move> Pawn::GetMoves(const Board& board,
-                                               uint32_t flags) const {
-  (void)flags;
-  std::vector<Move> moves;
-
-  uint8_t i = m_square.file;
-  uint8_t j = m_square.rank;
-
-  const auto square_front = (m_colour == Colour::WHITE)
-                                ? Square{i, static_cast<uint8_t>(j + 1)}
-                                : Square{i, static_cast<uint8_t>(j - 1)};
-  const auto square_front_two = (m_colour == Colour::WHITE)
-                                    ? Square{i, static_cast<uint8_t>(j + 2)}
-                                    : Square{i, static_cast<uint8_t>(j - 2)};
-  const auto square_left =
-      (m_colour == Colour::WHITE)
-          ? Square{static_cast<uint8_t>(i - 1), static_cast<uint8_t>(j + 1)}
-          : Square{static_cast<uint8_t>(i + 1), static_cast<uint8_t>(j - 1)};
-  const auto square_right =
-      (m_colour == Colour::WHITE)
-          ? Square{static_cast<uint8_t>(i + 1), static_cast<uint8_t>(j + 1)}
-          : Square{static_cast<uint8_t>(i - 1), static_cast<uint8_t>(j - 1)};
-
-  if (IsValidSquare(square_front)) {
-    const auto* piece_front = board.PieceAt(square_front);
-    if (piece_front == nullptr) {
-      moves.push_back(Move{m_square, square_front});
-    }
+Piece::Piece(Colour colour, PieceType type) : m_code(colour, type) {}
 
-    if (IsValidSquare(square_front_two)) {
-      const auto* piece_front_two = board.PieceAt(square_front_two);
-      if (!m_has_moved && (piece_front == nullptr) &&
-          (piece_front_two == nullptr)) {
-        moves.push_back(Move{m_square, square_front_two});
-      }
-    }
-  }
-
-  if (IsValidSquare(square_left)) {
-    const auto* piece_left = board.PieceAt(square_left);
-    if (piece_left != nullptr && (piece_left->GetColour() != m_colour)) {
-      moves.push_back(Move{m_square, square_left});
-    }
-  }
-
-  if (IsValidSquare(square_right)) {
-    const auto* piece_right = board.PieceAt(square_right);
-    if (piece_right != nullptr && (piece_right->GetColour() != m_colour)) {
-      moves.push_back(Move{m_square, square_right});
-    }
-  }
+Piece::Piece(PieceCode code) : m_code(code) {}
 
-  return moves;
-};
+[[nodiscard]] std::unique_ptr<Piece> Piece::Factory(PieceType type,
+                                                    Colour colour) {
+  return std::make_unique<Piece>(colour, type);
+}
 
-// KNIGHT
-Knight::Knight(Colour colour)
-    : Piece(colour, PieceType::KNIGHT, KNIGHT_VALUE) {}
+[[nodiscard]] const Piece* Piece::Get(PieceType type, Colour colour) {
+  static const std::array<std::array<Piece, 6>, 2> pieces{{
+      {Pawn(Colour::WHITE), Knight(Colour::WHITE), Bishop(Colour::WHITE),
+       Rook(Colour::WHITE), Queen(Colour::WHITE), King(Colour::WHITE)},
+      {Pawn(Colour::BLACK), Knight(Colour::BLACK), Bishop(Colour::BLACK),
+       Rook(Colour::BLACK), Queen(Colour::BLACK), King(Colour::BLACK)},
+  }};
 
-[[nodiscard]] std::unique_ptr<Piece> Knight::Clone() const {
-  return std::unique_ptr<Piece>(new Knight(*this));
+  return &pieces[static_cast<uint8_t>(colour)][static_cast<uint8_t>(type)];
 }
 
-[[nodiscard]] char Knight::GetFenChar() const {
-  if (m_colour == Colour::WHITE) {
-    return 'N';
-  } else {
-    return 'n';
-  }
-}
+[[nodiscard]] PieceCode Piece::GetCode() const { return m_code; }
 
-[[nodiscard]] std::vector<Move> Knight::GetMoves(const Board& board,
-                                                 uint32_t flags) const {
-  (void)flags;
-  std::vector<Move> moves;
-
-  uint8_t i = m_square.file;
-  uint8_t j = m_square.rank;
-
-  const std::vector<Square> dsts{
-      {static_cast<uint8_t>(i + 1), static_cast<uint8_t>(j + 2)},
-      {static_cast<uint8_t>(i + 2), static_cast<uint8_t>(j + 1)},
-      {static_cast<uint8_t>(i + 2), static_cast<uint8_t>(j - 1)},
-      {static_cast<uint8_t>(i + 1), static_cast<uint8_t>(j - 2)},
-      {static_cast<uint8_t>(i - 1), static_cast<uint8_t>(j + 2)},
-      {static_cast<uint8_t>(i - 2), static_cast<uint8_t>(j + 1)},
-      {static_cast<uint8_t>(i - 2), static_cast<uint8_t>(j - 1)},
-      {static_cast<uint8_t>(i - 1), static_cast<uint8_t>(j - 2)}};
-
-  for (const auto& dst_square : dsts) {
-    if (!IsValidSquare(dst_square)) {
-      continue;
-    }
-    const auto* dst_piece = board.PieceAt(dst_square);
-    if ((dst_piece == nullptr) || (dst_piece->GetColour() != m_colour)) {
-      moves.push_back({m_square, dst_square});
-    }
-  }
+[[nodiscard]] Colour Piece::GetColour() const { return m_code.GetColour(); }
 
-  return moves;
-};
+[[nodiscard]] PieceType Piece::GetType() const { return m_code.GetType(); }
 
-// BISHOP
-Bishop::Bishop(Colour colour)
-    : Piece(colour, PieceType::BISHOP, BISHOP_VALUE) {}
+[[nodiscard]] uint8_t Piece::GetValue() const { return m_code.GetValue(); }
 
-[[nodiscard]] std::unique_ptr<Piece> Bishop::Clone() const {
-  return std::unique_ptr<Piece>(new Bishop(*this));
+[[nodiscard]] std::unique_ptr<Piece> Piece::Clone() const {
+  return std::make_unique<Piece>(m_code);
 }
 
-[[nodiscard]] char Bishop::GetFenChar() const {
-  if (m_colour == Colour::WHITE) {
-    return 'B';
-  } else {
-    return 'b';
-  }
+void Piece::GetMoves(const Board& board, const Square& square,
+                     MoveList& moves, uint32_t flags) const {
+  GetPieceMoves(board, m_code, square, moves, flags);
 }
 
-[[nodiscard]] std::vector<Move> Bishop::GetMoves(const Board& board,
-                                                 uint32_t flags) const {
-  (void)flags;
-  std::vector<Move> moves;
-
-  std::vector<Move> up_left_moves = GetSlidingMoves(board, Direction::UP_LEFT);
-  std::vector<Move> up_right_moves =
-      GetSlidingMoves(board, Direction::UP_RIGHT);
-  std::vector<Move> down_left_moves =
-      GetSlidingMoves(board, Direction::DOWN_LEFT);
-  std::vector<Move> down_right_moves =
-      GetSlidingMoves(board, Direction::DOWN_RIGHT);
-
-  moves.insert(moves.end(), std::make_move_iterator(up_left_moves.begin()),
-               std::make_move_iterator(up_left_moves.end()));
-  moves.insert(moves.end(), std::make_move_iterator(up_right_moves.begin()),
-               std::make_move_iterator(up_right_moves.end()));
-  moves.insert(moves.end(), std::make_move_iterator(down_left_moves.begin()),
-               std::make_move_iterator(down_left_moves.end()));
-  moves.insert(moves.end(), std::make_move_iterator(down_right_moves.begin()),
-               std::make_move_iterator(down_right_moves.end()));
-
-  return moves;
-};
-
-// ROOK
-Rook::Rook(Colour colour) : Piece(colour, PieceType::ROOK, ROOK_VALUE) {}
-
-[[nodiscard]] std::unique_ptr<Piece> Rook::Clone() const {
-  return std::unique_ptr<Piece>(new Rook(*this));
-}
+[[nodiscard]] char Piece::GetFenChar() const { return m_code.GetFenChar(); }
 
-[[nodiscard]] char Rook::GetFenChar() const {
-  if (m_colour == Colour::WHITE) {
-    return 'R';
-  } else {
-    return 'r';
+void Piece::AddMoves(MoveList& moves, const Square& src, Bitboard targets) {
+  while (targets != EMPTY_BITBOARD) {
+    moves.Add(Move{src, IndexToSquare(PopLsb(targets))});
   }
 }
 
-[[nodiscard]] std::vector<Move> Rook::GetMoves(const Board& board,
-                                               uint32_t flags) const {
-  (void)flags;
-  std::vector<Move> moves;
-
-  std::vector<Move> up_moves = GetSlidingMoves(board, Direction::UP);
-  std::vector<Move> down_moves = GetSlidingMoves(board, Direction::DOWN);
-  std::vector<Move> left_moves = GetSlidingMoves(board, Direction::LEFT);
-  std::vector<Move> right_moves = GetSlidingMoves(board, Direction::RIGHT);
-
-  moves.insert(moves.end(), std::make_move_iterator(up_moves.begin()),
-               std::make_move_iterator(up_moves.end()));
-  moves.insert(moves.end(), std::make_move_iterator(down_moves.begin()),
-               std::make_move_iterator(down_moves.end()));
-  moves.insert(moves.end(), std::make_move_iterator(left_moves.begin()),
-               std::make_move_iterator(left_moves.end()));
-  moves.insert(moves.end(), std::make_move_iterator(right_moves.begin()),
-               std::make_move_iterator(right_moves.end()));
-
-  return moves;
-};
-
-// QUEEN
-Queen::Queen(Colour colour) : Piece(colour, PieceType::QUEEN, QUEEN_VALUE) {}
-
-[[nodiscard]] std::unique_ptr<Piece> Queen::Clone() const {
-  return std::unique_ptr<Piece>(new Queen(*this));
-}
-
-[[nodiscard]] char Queen::GetFenChar() const {
-  if (m_colour == Colour::WHITE) {
-    return 'Q';
-  } else {
-    return 'q';
+void Piece::AddPawnMoves(MoveList& moves, const Square& src,
+                         Bitboard targets) {
+  constexpr Bitboard last_ranks = RankBitboard(0) | RankBitboard(7);
+  AddMoves(moves, src, targets & ~last_ranks);
+
+  Bitboard promotions = targets & last_ranks;
+  while (promotions != EMPTY_BITBOARD) {
+    const Square dst = IndexToSquare(PopLsb(promotions));
+    for (const PieceType type : {PieceType::QUEEN, PieceType::ROOK,
+                                 PieceType::BISHOP, PieceType::KNIGHT}) {
+      moves.Add(Move{src, dst, true, type});
+    }
   }
 }
 
-[[nodiscard]] std::vector<Move> Queen::GetMoves(const Board& board,
-                                                uint32_t flags) const {
-  (void)flags;
-  std::vector<Move> moves;
-
-  std::vector<Move> up_moves = GetSlidingMoves(board, Direction::UP);
-  std::vector<Move> down_moves = GetSlidingMoves(board, Direction::DOWN);
-  std::vector<Move> left_moves = GetSlidingMoves(board, Direction::LEFT);
-  std::vector<Move> right_moves = GetSlidingMoves(board, Direction::RIGHT);
-  std::vector<Move> up_left_moves = GetSlidingMoves(board, Direction::UP_LEFT);
-  std::vector<Move> up_right_moves =
-      GetSlidingMoves(board, Direction::UP_RIGHT);
-  std::vector<Move> down_left_moves =
-      GetSlidingMoves(board, Direction::DOWN_LEFT);
-  std::vector<Move> down_right_moves =
-      GetSlidingMoves(board, Direction::DOWN_RIGHT);
-
-  moves.insert(moves.end(), std::make_move_iterator(up_moves.begin()),
-               std::make_move_iterator(up_moves.end()));
-  moves.insert(moves.end(), std::make_move_iterator(down_moves.begin()),
-               std::make_move_iterator(down_moves.end()));
-  moves.insert(moves.end(), std::make_move_iterator(left_moves.begin()),
-               std::make_move_iterator(left_moves.end()));
-  moves.insert(moves.end(), std::make_move_iterator(right_moves.begin()),
-               std::make_move_iterator(right_moves.end()));
-  moves.insert(moves.end(), std::make_move_iterator(up_left_moves.begin()),
-               std::make_move_iterator(up_left_moves.end()));
-  moves.insert(moves.end(), std::make_move_iterator(up_right_moves.begin()),
-               std::make_move_iterator(up_right_moves.end()));
-  moves.insert(moves.end(), std::make_move_iterator(down_left_moves.begin()),
-               std::make_move_iterator(down_left_moves.end()));
-  moves.insert(moves.end(), std::make_move_iterator(down_right_moves.begin()),
-               std::make_move_iterator(down_right_moves.end()));
-
-  return moves;
-};
-
-// KING
-King::King(Colour colour) : Piece(colour, PieceType::KING, KING_VALUE) {}
-
-[[nodiscard]] std::unique_ptr<Piece> King::Clone() const {
-  return std::unique_ptr<Piece>(new King(*this));
-}
+Pawn::Pawn(Colour colour) : Piece(colour, PieceType::PAWN) {}
 
-[[nodiscard]] char King::GetFenChar() const {
-  if (m_colour == Colour::WHITE) {
-    return 'K';
-  } else {
-    return 'k';
-  }
-}
+Knight::Knight(Colour colour) : Piece(colour, PieceType::KNIGHT) {}
 
-[[nodiscard]] std::vector<Move> King::GetMoves(const Board& board,
-                                               uint32_t flags) const {
-  std::vector<Move> moves;
+Bishop::Bishop(Colour colour) : Piece(colour, PieceType::BISHOP) {}
 
-  uint8_t i = m_square.file;
-  uint8_t j = m_square.rank;
+Rook::Rook(Colour colour) : Piece(colour, PieceType::ROOK) {}
 
-  for (int8_t di = -1; di < 2; ++di) {
-    for (int8_t dj = -1; dj < 2; ++dj) {
-      const Square dst_square = {static_cast<uint8_t>(i + di),
-                                 static_cast<uint8_t>(j + dj)};
-      if (!IsValidSquare(dst_square)) {
-        continue;
-      }
-      const auto* dst_piece = board.PieceAt(dst_square);
-      if ((dst_piece == nullptr) || (dst_piece->GetColour() != m_colour)) {
-        const Move move{m_square, dst_square};
-        if (!IsMoveInBoard(move)) {
-          continue;
-        }
-        moves.push_back(move);
-      }
-    }
-  }
-
-  // Castles
-  const bool include_castles = ((flags & FLAG_EXCLUDE_CASTLES) == 0);
-  if (include_castles) {
-    if (m_colour == Colour::WHITE) {
-      if (board.CanWKC()) {
-        moves.push_back(WHITE_KING_CASTLE);
-      }
-      if (board.CanWQC()) {
-        moves.push_back(WHITE_QUEEN_CASTLE);
-      }
-    } else {
-      if (board.CanBKC()) {
-        moves.push_back(BLACK_KING_CASTLE);
-      }
-      if (board.CanBQC()) {
-        moves.push_back(BLACK_QUEEN_CASTLE);
-      }
-    }
-  }
+Queen::Queen(Colour colour) : Piece(colour, PieceType::QUEEN) {}
 
-  return moves;
-};
+King::King(Colour colour) : Piece(colour, PieceType::KING) {}
 
 }  // namespace chess
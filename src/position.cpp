@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "position.hpp"
+
+#include <cassert>
+#include <type_traits>
+
+namespace chess {
+
+static_assert(std::is_trivially_copyable_v<Position>);
+
+Position::Position() { Clear(); }
+
+void Position::Clear() {
+  m_pieces.fill(EMPTY_BITBOARD);
+  m_colours.fill(EMPTY_BITBOARD);
+  m_mailbox.fill(PieceCode());
+  m_counts = {};
+  m_material.fill(0);
+  m_psq_scores.fill(0);
+}
+
+void Position::SetPiece(uint8_t index, Colour colour, PieceType type) {
+  RemovePiece(index);
+
+  const PieceCode piece(colour, type);
+  const uint8_t c = static_cast<uint8_t>(colour);
+  const Bitboard bit = SquareBit(index);
+  m_pieces[static_cast<uint8_t>(type)] |= bit;
+  m_colours[c] |= bit;
+  m_mailbox[index] = piece;
+
+  m_counts[c][static_cast<uint8_t>(type)]++;
+  if (type != PieceType::KING) {
+    m_material[c] += piece.GetValue();
+  }
+  m_psq_scores[c] += PieceSquareValue(colour, type, index);
+}
+
+void Position::RemovePiece(uint8_t index) {
+  if (IsEmpty(index)) {
+    return;
+  }
+
+  const PieceCode piece = m_mailbox[index];
+  const Colour colour = piece.GetColour();
+  const PieceType type = piece.GetType();
+  const uint8_t c = static_cast<uint8_t>(colour);
+  const Bitboard bit = SquareBit(index);
+  m_pieces[static_cast<uint8_t>(type)] &= ~bit;
+  m_colours[c] &= ~bit;
+  m_mailbox[index] = PieceCode();
+
+  m_counts[c][static_cast<uint8_t>(type)]--;
+  if (type != PieceType::KING) {
+    m_material[c] -= piece.GetValue();
+  }
+  m_psq_scores[c] -= PieceSquareValue(colour, type, index);
+}
+
+void Position::MovePiece(uint8_t src, uint8_t dst) {
+  const PieceCode piece = m_mailbox[src];
+  assert(!piece.IsNone());
+  const Colour colour = piece.GetColour();
+  const PieceType type = piece.GetType();
+  const Bitboard src_dst = SquareBit(src) | SquareBit(dst);
+  m_pieces[static_cast<uint8_t>(type)] ^= src_dst;
+  m_colours[static_cast<uint8_t>(colour)] ^= src_dst;
+  m_mailbox[dst] = piece;
+  m_mailbox[src] = PieceCode();
+
+  m_psq_scores[static_cast<uint8_t>(colour)] +=
+      PieceSquareValue(colour, type, dst) - PieceSquareValue(colour, type, src);
+}
+
+}  // namespace chess
@@ -0,0 +1,592 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "search.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+#include "movelist.hpp"
+#include "movepicker.hpp"
+
+namespace chess {
+
+namespace {
+
+// Piece values are kept in pawns, the piece-square bonuses in centipawns
+constexpr int CENTIPAWNS_PER_PAWN = 100;
+
+// A capture that cannot bring the static evaluation near alpha even winning
+// its victim for free, plus this margin for positional gains, is not searched
+// by the quiescence search
+constexpr int DELTA_MARGIN = 200;
+
+// The clock is read once every this many nodes. Must be a power of two.
+constexpr uint64_t CLOCK_CHECK_INTERVAL = 2048;
+
+// Depths skipped by the helper threads of a Lazy SMP search, so that they do
+// not all search the same depth as the main thread. Helper i skips the
+// depths d for which (d + SKIP_PHASE[i]) / SKIP_SIZE[i] is odd.
+constexpr std::array<uint8_t, 20> SKIP_SIZE{1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                            3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+constexpr std::array<uint8_t, 20> SKIP_PHASE{0, 1, 0, 1, 2, 3, 0, 1, 2, 3,
+                                             4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+[[nodiscard]] bool IsMateScore(int score) {
+  return std::abs(score) >= MATE_SCORE - MAX_PLY;
+}
+
+/**
+ * @brief Moves to mate from a mate score, negative if the side to move is
+ * mated.
+ */
+[[nodiscard]] int MateCounter(int score) {
+  const int plies = MATE_SCORE - std::abs(score);
+  return (score > 0) ? (plies + 1) / 2 : -(plies / 2);
+}
+
+/**
+ * @brief Value in pawns of the piece a move captures, if any.
+ */
+[[nodiscard]] int CapturedValue(const Board& board, const Move& move) {
+  const PieceCode victim = board.GetPiece(move.dst);
+  if (!victim.IsNone()) {
+    return victim.GetValue();
+  }
+  // A pawn changing file without capturing on its destination is en passant
+  const PieceCode piece = board.GetPiece(move.src);
+  const bool is_en_passant = (piece.GetType() == PieceType::PAWN) &&
+                             (move.src.file != move.dst.file);
+  return is_en_passant ? PAWN_VALUE : 0;
+}
+
+/**
+ * @brief Mate scores are stored in the transposition table as the distance
+ * to mate from the stored position, which may be reached at other plies.
+ */
+[[nodiscard]] int16_t ScoreToTable(int score, uint8_t ply) {
+  if (IsMateScore(score)) {
+    score += (score > 0) ? ply : -ply;
+  }
+  return static_cast<int16_t>(score);
+}
+
+[[nodiscard]] int ScoreFromTable(int16_t score, uint8_t ply) {
+  if (IsMateScore(score)) {
+    return (score > 0) ? score - ply : score + ply;
+  }
+  return score;
+}
+
+}  // namespace
+
+int Evaluate(const Board& board) {
+  const Colour us = board.GetSideToMove();
+  const Colour them = OppositeColour(us);
+  const int material = board.GetMaterial(us) - board.GetMaterial(them);
+  const int psq_score = board.GetPsqScore(us) - board.GetPsqScore(them);
+  return (CENTIPAWNS_PER_PAWN * material) + psq_score;
+}
+
+class Search::Worker {
+ public:
+  Worker(Search& search, std::size_t id) : m_search(search), m_id(id) {}
+
+  /**
+   * @brief Iterative deepening from depth 1. Only the main worker reports
+   * its iterations.
+   */
+  SearchResult Run(const Board& board, const BoardHistory* history,
+                   uint8_t max_depth);
+
+  [[nodiscard]] uint64_t GetNodes() const {
+    return m_nodes.load(std::memory_order_relaxed);
+  }
+
+ private:
+  Search& m_search;
+  const std::size_t m_id;
+  Board m_board;
+  BoardHistory m_board_history;
+  // Only written by the worker's own thread, but read by the main thread
+  std::atomic<uint64_t> m_nodes = 0;
+
+  // Triangular table: the principal variation from each ply
+  std::array<std::array<Move, MAX_PLY>, MAX_PLY> m_pv;
+  std::array<uint8_t, MAX_PLY> m_pv_length;
+
+  // Move ordering state, kept for the whole search
+  std::array<Killers, MAX_PLY> m_killers;
+  MoveHistory m_history;
+  // Move played at each ply, to look up counter moves
+  std::array<PackedMove, MAX_PLY> m_played;
+
+  [[nodiscard]] bool IsMainWorker() const { return m_id == 0; }
+
+  [[nodiscard]] bool ShouldSkipDepth(uint8_t depth) const;
+
+  /**
+   * @brief Search the root moves at a depth, trying the previous best move
+   * first.
+   */
+  int SearchRoot(MoveList& moves, uint8_t depth);
+
+  int Negamax(int alpha, int beta, uint8_t depth, uint8_t ply);
+
+  /**
+   * @brief Search only captures and promotions from a leaf, or every move if
+   * in check, until the position is quiet, so that the evaluation of a leaf
+   * does not miss a piece about to be lost.
+   */
+  int Quiescence(int alpha, int beta, uint8_t ply);
+
+  /**
+   * @brief Check the stop flag and, every few thousand nodes, the clock.
+   */
+  [[nodiscard]] bool ShouldStop();
+
+  void UpdatePV(uint8_t ply, const Move& move);
+
+  /**
+   * @brief Record a quiet move causing a cutoff as a killer and in the
+   * history, and penalise the quiet moves searched before it.
+   */
+  void UpdateQuietStats(Colour side, uint8_t ply, uint8_t depth,
+                        const Move& move, const MoveList& quiets_searched);
+};
+
+Search::Search() { SetNumThreads(1); }
+
+Search::~Search() = default;
+
+void Search::SetInfoCallback(InfoCallback callback) {
+  m_info_callback = std::move(callback);
+}
+
+void Search::SetHashSize(std::size_t size_mb) { m_table.Resize(size_mb); }
+
+void Search::ClearHash() { m_table.Clear(); }
+
+void Search::SetNumThreads(std::size_t num_threads) {
+  if (num_threads == 0) {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  m_helper_pool.reset();
+  m_workers.clear();
+  for (std::size_t i = 0; i < num_threads; ++i) {
+    m_workers.push_back(std::make_unique<Worker>(*this, i));
+  }
+  if (num_threads > 1) {
+    m_helper_pool = std::make_unique<ThreadPool>(num_threads - 1);
+  }
+}
+
+void Search::Stop() { m_stop.store(true, std::memory_order_relaxed); }
+
+void Search::ClearStop() { m_stop.store(false, std::memory_order_relaxed); }
+
+std::optional<SearchInfo> Search::GetLine() const { return m_line; }
+
+uint64_t Search::CountNodes() const {
+  uint64_t nodes = 0;
+  for (const auto& worker : m_workers) {
+    nodes += worker->GetNodes();
+  }
+  return nodes;
+}
+
+SearchResult Search::Run(const Board& board, const SearchLimits& limits,
+                         const BoardHistory* history) {
+  // A pending stop is kept: it was sent for this search before it started
+  m_nodes = 0;
+  m_line.reset();
+  m_table.NewSearch();
+  m_deadline.reset();
+  if (limits.msec > 0) {
+    m_deadline = Clock::now() + std::chrono::milliseconds(limits.msec);
+  }
+
+  const uint8_t max_depth = std::clamp<uint8_t>(limits.depth, 1, MAX_PLY);
+  for (std::size_t i = 1; i < m_workers.size(); ++i) {
+    Worker* helper = m_workers[i].get();
+    m_helper_pool->Submit([helper, &board, history, max_depth] {
+      helper->Run(board, history, max_depth);
+    });
+  }
+
+  const SearchResult result = m_workers[0]->Run(board, history, max_depth);
+
+  // The helpers search until the main thread is done
+  Stop();
+  if (m_helper_pool != nullptr) {
+    m_helper_pool->Wait();
+  }
+  m_nodes = CountNodes();
+  ClearStop();
+
+  return result;
+}
+
+SearchResult Search::Worker::Run(const Board& board,
+                                 const BoardHistory* history,
+                                 uint8_t max_depth) {
+  m_board = board;
+  if (history != nullptr) {
+    m_board_history = *history;
+  } else {
+    m_board_history.Clear();
+  }
+  m_nodes = 0;
+  m_killers.fill(Killers{});
+  m_history.Clear();
+
+  SearchResult result;
+  MoveList moves;
+  m_board.GenerateLegalMoves(moves);
+  if (moves.IsEmpty()) {
+    return result;
+  }
+
+  // Something to play even if the first iteration is interrupted
+  result.bestmove = moves[0];
+
+  for (uint8_t depth = 1; depth <= max_depth; ++depth) {
+    if (ShouldSkipDepth(depth)) {
+      continue;
+    }
+
+    const int score = SearchRoot(moves, depth);
+    if (m_search.m_stop) {
+      break;
+    }
+
+    // The next iteration starts from the best move of this one
+    const Move& best_move = m_pv[0][0];
+    const auto best = std::find(moves.begin(), moves.end(), best_move);
+    std::rotate(moves.begin(), best, best + 1);
+
+    if (!IsMainWorker()) {
+      continue;
+    }
+
+    SearchInfo info{depth,
+                    {m_pv[0].begin(), m_pv[0].begin() + m_pv_length[0]},
+                    IsMateScore(score),
+                    score,
+                    m_search.CountNodes()};
+    if (info.mate_counter) {
+      info.score = MateCounter(score);
+    }
+
+    result.bestmove = info.pv[0];
+    result.ponder.reset();
+    if (info.pv.size() > 1) {
+      result.ponder = info.pv[1];
+    }
+
+    m_search.m_line = info;
+    if (m_search.m_info_callback) {
+      m_search.m_info_callback(info);
+    }
+  }
+
+  return result;
+}
+
+bool Search::Worker::ShouldSkipDepth(uint8_t depth) const {
+  if (IsMainWorker()) {
+    return false;
+  }
+
+  const std::size_t i = (m_id - 1) % SKIP_SIZE.size();
+  return (((depth + SKIP_PHASE[i]) / SKIP_SIZE[i]) % 2) != 0;
+}
+
+int Search::Worker::SearchRoot(MoveList& moves, uint8_t depth) {
+  m_pv_length[0] = 0;
+  int alpha = -INFINITE_SCORE;
+  const int beta = INFINITE_SCORE;
+
+  for (std::size_t i = 0; i < moves.Size(); ++i) {
+    const Move& move = moves[i];
+    m_played[0] = PackedMove(move);
+    m_board.MakeMove(move, m_board_history);
+    int score;
+    if (i == 0) {
+      score = -Negamax(-beta, -alpha, depth - 1, 1);
+    } else {
+      score = -Negamax(-alpha - 1, -alpha, depth - 1, 1);
+      if (score > alpha) {
+        score = -Negamax(-beta, -alpha, depth - 1, 1);
+      }
+    }
+    m_board.UnmakeMove(m_board_history);
+
+    if (m_search.m_stop) {
+      break;
+    }
+    if (score > alpha) {
+      alpha = score;
+      UpdatePV(0, move);
+    }
+  }
+
+  if (!m_search.m_stop) {
+    m_search.m_table.Store(m_board.Hash(), {m_board.PackMove(m_pv[0][0]),
+                                            ScoreToTable(alpha, 0), depth,
+                                            TranspositionTable::Bound::EXACT});
+  }
+
+  return alpha;
+}
+
+int Search::Worker::Negamax(int alpha, int beta, uint8_t depth, uint8_t ply) {
+  m_pv_length[ply] = ply;
+  if (ShouldStop()) {
+    return 0;
+  }
+
+  // Draws by rule go before the transposition table, whose score for the
+  // position may come from a path without the repetition or with a lower
+  // half-move clock. The root, searched by SearchRoot, is never scored as a
+  // draw, so that a move is still chosen.
+  const auto is_in_check = [this] {
+    return m_board.IsInCheck(m_board.GetSideToMove());
+  };
+  if (m_board.CountRepetitions(m_board_history) > 0) {
+    return 0;
+  }
+  // Only a checkmate takes precedence over the fifty-move rule
+  if (m_board.IsFiftyMoveRule()) {
+    if (is_in_check()) {
+      MoveList moves;
+      m_board.GenerateLegalMoves(moves);
+      return moves.IsEmpty() ? -MATE_SCORE + ply : 0;
+    }
+    return 0;
+  }
+
+  if ((depth == 0) || (ply >= MAX_PLY - 1)) {
+    return Quiescence(alpha, beta, ply);
+  }
+
+  // Counted here so that each node is counted once: leaves by Quiescence,
+  // and positions drawn by rule are not searched
+  m_nodes.store(m_nodes.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+
+  // Principal variation nodes are not cut off, to keep the line complete
+  const bool is_pv_node = (beta - alpha > 1);
+  const uint64_t hash = m_board.Hash();
+  TranspositionTable::Entry entry;
+  const bool is_hit = m_search.m_table.Probe(hash, &entry);
+  if (is_hit && !is_pv_node && (entry.depth >= depth)) {
+    using Bound = TranspositionTable::Bound;
+    const int score = ScoreFromTable(entry.score, ply);
+    if ((entry.bound == Bound::EXACT) ||
+        ((entry.bound == Bound::LOWER) && (score >= beta)) ||
+        ((entry.bound == Bound::UPPER) && (score <= alpha))) {
+      return score;
+    }
+  }
+
+  const Colour side = m_board.GetSideToMove();
+  Killers& killers = m_killers[ply];
+  const PackedMove previous = m_played[ply - 1];
+  MovePicker picker(m_board, is_hit ? entry.move : PackedMove(), killers,
+                    m_history.GetCounterMove(previous), m_history);
+
+  const int original_alpha = alpha;
+  int best_score = -INFINITE_SCORE;
+  std::optional<Move> best_move;
+  MoveList quiets_searched;
+  std::size_t num_searched = 0;
+  while (const std::optional<Move> next = picker.Next()) {
+    const Move& move = next.value();
+    const bool is_quiet = !m_board.IsNoisyMove(move);
+    m_played[ply] = PackedMove(move);
+
+    m_board.MakeMove(move, m_board_history);
+    int score;
+    if (num_searched == 0) {
+      score = -Negamax(-beta, -alpha, depth - 1, ply + 1);
+    } else {
+      // Prove with a null window that the move is worse than the first one,
+      // and search it fully only if it is not.
+      score = -Negamax(-alpha - 1, -alpha, depth - 1, ply + 1);
+      if ((score > alpha) && (score < beta)) {
+        score = -Negamax(-beta, -alpha, depth - 1, ply + 1);
+      }
+    }
+    m_board.UnmakeMove(m_board_history);
+    num_searched++;
+
+    if (m_search.m_stop) {
+      return 0;
+    }
+    if (score > best_score) {
+      best_score = score;
+    }
+    if (score > alpha) {
+      alpha = score;
+      best_move = move;
+      UpdatePV(ply, move);
+      if (alpha >= beta) {
+        if (is_quiet) {
+          UpdateQuietStats(side, ply, depth, move, quiets_searched);
+        }
+        break;
+      }
+    }
+    if (is_quiet) {
+      quiets_searched.Add(move);
+    }
+  }
+
+  if (num_searched == 0) {
+    return is_in_check() ? -MATE_SCORE + ply : 0;
+  }
+
+  TranspositionTable::Bound bound = TranspositionTable::Bound::EXACT;
+  if (best_score >= beta) {
+    bound = TranspositionTable::Bound::LOWER;
+  } else if (best_score <= original_alpha) {
+    bound = TranspositionTable::Bound::UPPER;
+  }
+  const PackedMove packed_move = best_move.has_value()
+                                     ? m_board.PackMove(best_move.value())
+                                     : PackedMove();
+  m_search.m_table.Store(
+      hash, {packed_move, ScoreToTable(best_score, ply), depth, bound});
+
+  return best_score;
+}
+
+int Search::Worker::Quiescence(int alpha, int beta, uint8_t ply) {
+  m_pv_length[ply] = ply;
+  if (ShouldStop()) {
+    return 0;
+  }
+  m_nodes.store(m_nodes.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+
+  if (ply >= MAX_PLY - 1) {
+    return Evaluate(m_board);
+  }
+
+  // In check there is no standing pat: every evasion is searched
+  const bool is_in_check = m_board.IsInCheck(m_board.GetSideToMove());
+  int best_score = -INFINITE_SCORE;
+  int stand_pat = 0;
+  if (!is_in_check) {
+    stand_pat = Evaluate(m_board);
+    if (stand_pat >= beta) {
+      return stand_pat;
+    }
+    alpha = std::max(alpha, stand_pat);
+    best_score = stand_pat;
+  }
+
+  MovePicker picker =
+      is_in_check ? MovePicker(m_board, PackedMove(), m_killers[ply],
+                               PackedMove(), m_history)
+                  : MovePicker(m_board);
+  std::size_t num_searched = 0;
+  while (const std::optional<Move> next = picker.Next()) {
+    const Move& move = next.value();
+    num_searched++;
+    if (!is_in_check) {
+      // Delta pruning: even winning the victim leaves the score below alpha
+      const int gain = CENTIPAWNS_PER_PAWN * CapturedValue(m_board, move);
+      if (!move.is_pawn_promotion &&
+          (stand_pat + gain + DELTA_MARGIN <= alpha)) {
+        continue;
+      }
+      // SEE pruning: the exchange on the destination loses material
+      if (m_board.SEE(move) < 0) {
+        continue;
+      }
+    }
+
+    m_board.MakeMove(move, m_board_history);
+    const int score = -Quiescence(-beta, -alpha, ply + 1);
+    m_board.UnmakeMove(m_board_history);
+
+    if (m_search.m_stop) {
+      return 0;
+    }
+    if (score > best_score) {
+      best_score = score;
+      if (score > alpha) {
+        alpha = score;
+        if (alpha >= beta) {
+          break;
+        }
+      }
+    }
+  }
+
+  if (is_in_check && (num_searched == 0)) {
+    return -MATE_SCORE + ply;
+  }
+
+  return best_score;
+}
+
+bool Search::Worker::ShouldStop() {
+  if (m_search.m_stop.load(std::memory_order_relaxed)) {
+    return true;
+  }
+
+  const auto& deadline = m_search.m_deadline;
+  if (deadline.has_value() &&
+      ((GetNodes() & (CLOCK_CHECK_INTERVAL - 1)) == 0) &&
+      (Clock::now() >= deadline.value())) {
+    m_search.Stop();
+    return true;
+  }
+
+  return false;
+}
+
+void Search::Worker::UpdatePV(uint8_t ply, const Move& move) {
+  m_pv[ply][ply] = move;
+  for (uint8_t i = ply + 1; i < m_pv_length[ply + 1]; ++i) {
+    m_pv[ply][i] = m_pv[ply + 1][i];
+  }
+  m_pv_length[ply] = std::max<uint8_t>(m_pv_length[ply + 1], ply + 1);
+}
+
+void Search::Worker::UpdateQuietStats(Colour side, uint8_t ply,
+                                      uint8_t depth, const Move& move,
+                                      const MoveList& quiets_searched) {
+  const PackedMove packed(move);
+  Killers& killers = m_killers[ply];
+  if (killers[0] != packed) {
+    killers[1] = killers[0];
+    killers[0] = packed;
+  }
+
+  m_history.AddCutoff(side, m_played[ply - 1], packed, depth);
+  for (const Move& quiet : quiets_searched) {
+    m_history.AddFailure(side, PackedMove(quiet), depth);
+  }
+}
+
+}  // namespace chess
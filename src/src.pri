@@ -1,12 +1,23 @@
 APP_MAIN = $$PWD/main.cpp
 
-SOURCES += \
-  $$APP_MAIN \
+CORE_SOURCES = \
   $$PWD/chess.cpp \
+  $$PWD/position.cpp \
+  $$PWD/magic.cpp \
   $$PWD/piece.cpp \
   $$PWD/board.cpp \
+  $$PWD/threadpool.cpp \
+  $$PWD/perft.cpp \
+  $$PWD/transpositiontable.cpp \
+  $$PWD/movepicker.cpp \
+  $$PWD/search.cpp
+
+SOURCES += \
+  $$APP_MAIN \
+  $$CORE_SOURCES \
   $$PWD/mainwindow.cpp \
   $$PWD/settingsdialog.cpp \
   $$PWD/uciengine.cpp \
+  $$PWD/nativeengine.cpp \
   $$PWD/chessboardwidget.cpp \
   $$PWD/player.cpp
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "threadpool.hpp"
+
+#include <algorithm>
+
+namespace chess {
+
+ThreadPool::ThreadPool(std::size_t num_threads) {
+  if (num_threads == 0) {
+    num_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+
+  for (std::size_t i = 0; i < num_threads; ++i) {
+    m_queues.push_back(std::make_unique<Queue>());
+  }
+  for (std::size_t i = 0; i < num_threads; ++i) {
+    m_threads.emplace_back(&ThreadPool::WorkerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_work_available.notify_all();
+
+  for (auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  const std::size_t index = m_next_queue++ % m_queues.size();
+  {
+    // The counters are updated before the task can be taken, so a task
+    // cannot finish before it is counted.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queued++;
+    m_pending++;
+
+    std::lock_guard<std::mutex> queue_lock(m_queues[index]->mutex);
+    m_queues[index]->tasks.push_back(std::move(task));
+  }
+  m_work_available.notify_one();
+}
+
+void ThreadPool::Wait() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_all_done.wait(lock, [this] { return m_pending == 0; });
+}
+
+bool ThreadPool::PopTask(std::size_t index, std::function<void()>& task) {
+  {
+    Queue& own = *m_queues[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+
+  for (std::size_t i = 1; i < m_queues.size(); ++i) {
+    Queue& other = *m_queues[(index + i) % m_queues.size()];
+    std::lock_guard<std::mutex> lock(other.mutex);
+    if (!other.tasks.empty()) {
+      task = std::move(other.tasks.front());
+      other.tasks.pop_front();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ThreadPool::WorkerLoop(std::size_t index) {
+  std::function<void()> task;
+
+  while (true) {
+    if (PopTask(index, task)) {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queued--;
+      }
+
+      task();
+      task = nullptr;
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (--m_pending == 0) {
+        m_all_done.notify_all();
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_work_available.wait(lock, [this] { return m_stop || (m_queued > 0); });
+    if (m_stop && (m_queued == 0)) {
+      return;
+    }
+  }
+}
+
+}  // namespace chess
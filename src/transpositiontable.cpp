@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "transpositiontable.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace chess {
+
+namespace {
+
+// Layout of the data word of an entry: move in bits 0-15, score in bits
+// 16-31, depth in bits 32-39, bound in bits 40-47 and age in bits 48-55.
+// Every stored entry has a bound, so an empty slot is all zeros.
+[[nodiscard]] uint64_t PackData(const TranspositionTable::Entry& entry,
+                                uint8_t age) {
+  return static_cast<uint64_t>(entry.move.GetRaw()) |
+         (static_cast<uint64_t>(static_cast<uint16_t>(entry.score)) << 16) |
+         (static_cast<uint64_t>(entry.depth) << 32) |
+         (static_cast<uint64_t>(entry.bound) << 40) |
+         (static_cast<uint64_t>(age) << 48);
+}
+
+[[nodiscard]] TranspositionTable::Entry UnpackData(uint64_t data) {
+  using Bound = TranspositionTable::Bound;
+  return {PackedMove::FromRaw(static_cast<uint16_t>(data)),
+          static_cast<int16_t>(static_cast<uint16_t>(data >> 16)),
+          static_cast<uint8_t>(data >> 32),
+          static_cast<Bound>(static_cast<uint8_t>(data >> 40))};
+}
+
+[[nodiscard]] uint8_t DataAge(uint64_t data) {
+  return static_cast<uint8_t>(data >> 48);
+}
+
+// Number of buckets sampled by Hashfull
+constexpr std::size_t HASHFULL_SAMPLE = 250;
+
+}  // namespace
+
+TranspositionTable::TranspositionTable(std::size_t size_mb) {
+  Resize(size_mb);
+}
+
+void TranspositionTable::Resize(std::size_t size_mb) {
+  const std::size_t size = std::bit_floor(
+      std::max<std::size_t>(1, (size_mb << 20) / sizeof(Bucket)));
+  m_buckets.reset();
+  m_buckets = std::make_unique<Bucket[]>(size);
+  m_mask = size - 1;
+  m_age = 0;
+}
+
+void TranspositionTable::Clear() {
+  for (std::size_t i = 0; i <= m_mask; ++i) {
+    for (Slot& slot : m_buckets[i].entries) {
+      slot.key.store(0, std::memory_order_relaxed);
+      slot.data.store(0, std::memory_order_relaxed);
+    }
+  }
+  m_age = 0;
+}
+
+bool TranspositionTable::Probe(uint64_t hash, Entry* entry) const {
+  const Bucket& bucket = m_buckets[hash & m_mask];
+  for (const Slot& slot : bucket.entries) {
+    const uint64_t data = slot.data.load(std::memory_order_relaxed);
+    const uint64_t key = slot.key.load(std::memory_order_relaxed);
+    if ((data != 0) && ((key ^ data) == hash)) {
+      *entry = UnpackData(data);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void TranspositionTable::Store(uint64_t hash, const Entry& entry) {
+  Bucket& bucket = m_buckets[hash & m_mask];
+
+  // Overwrite the entry of the same position if there is one. Otherwise,
+  // replace the least valuable entry: the shallowest, counting entries of
+  // older searches as shallower.
+  Slot* replaced = nullptr;
+  int lowest_value = std::numeric_limits<int>::max();
+  uint64_t replaced_data = 0;
+  for (Slot& slot : bucket.entries) {
+    const uint64_t data = slot.data.load(std::memory_order_relaxed);
+    const uint64_t key = slot.key.load(std::memory_order_relaxed);
+    if ((data != 0) && ((key ^ data) == hash)) {
+      replaced = &slot;
+      replaced_data = data;
+      break;
+    }
+
+    const uint8_t age_difference = static_cast<uint8_t>(m_age - DataAge(data));
+    const int value = (data == 0) ? std::numeric_limits<int>::min()
+                                  : static_cast<int>(UnpackData(data).depth) -
+                                        (4 * age_difference);
+    if (value < lowest_value) {
+      replaced = &slot;
+      lowest_value = value;
+      replaced_data = 0;
+    }
+  }
+
+  // Keep the move of a previous search of the position if this one has none
+  Entry stored = entry;
+  if (stored.move.IsNull() && (replaced_data != 0)) {
+    stored.move = UnpackData(replaced_data).move;
+  }
+
+  const uint64_t data = PackData(stored, m_age);
+  replaced->key.store(hash ^ data, std::memory_order_relaxed);
+  replaced->data.store(data, std::memory_order_relaxed);
+}
+
+uint16_t TranspositionTable::Hashfull() const {
+  const std::size_t num_buckets = std::min(HASHFULL_SAMPLE, m_mask + 1);
+  std::size_t used = 0;
+  for (std::size_t i = 0; i < num_buckets; ++i) {
+    for (const Slot& slot : m_buckets[i].entries) {
+      const uint64_t data = slot.data.load(std::memory_order_relaxed);
+      if ((data != 0) && (DataAge(data) == m_age)) {
+        used++;
+      }
+    }
+  }
+
+  return static_cast<uint16_t>((used * 1000) / (num_buckets * BUCKET_SIZE));
+}
+
+}  // namespace chess
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "arena.hpp"
+
+#include <gtest/gtest.h>
+
+#include "board.hpp"
+
+TEST(ArenaTest, EmplaceAndReset) {
+  chess::Arena<int> arena(3);
+  EXPECT_TRUE(arena.IsEmpty());
+  EXPECT_EQ(arena.Capacity(), 3);
+
+  EXPECT_EQ(*arena.Emplace(1), 1);
+  arena.Emplace(2);
+  int* last = arena.Emplace(3);
+  EXPECT_TRUE(arena.IsFull());
+  EXPECT_EQ(arena.Emplace(4), nullptr);
+
+  // Objects are contiguous
+  EXPECT_EQ(last, &arena[0] + 2);
+  int sum = 0;
+  for (int value : arena) {
+    sum += value;
+  }
+  EXPECT_EQ(sum, 6);
+
+  arena.Reset();
+  EXPECT_TRUE(arena.IsEmpty());
+  EXPECT_EQ(arena.Emplace(5), &arena[0]);
+  EXPECT_EQ(arena.Size(), 1);
+}
+
+TEST(ArenaTest, BoardSnapshots) {
+  chess::Board board;
+  ASSERT_TRUE(
+      board.FromFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1")
+          .IsOk());
+
+  chess::Arena<chess::Board::Snapshot> arena(4);
+  arena.Emplace(board.GetSnapshot());
+  for (const char* uci : {"e2e4", "c7c5", "g1f3"}) {
+    board.DoMove(chess::UCIToMove(uci));
+    arena.Emplace(board.GetSnapshot());
+  }
+
+  chess::Board restored(arena[2]);
+  EXPECT_EQ(restored.GetFEN(),
+            "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w KQkq c6 0 2");
+  EXPECT_EQ(restored.Hash(), restored.ComputeHash());
+
+  restored.SetSnapshot(arena[3]);
+  EXPECT_EQ(restored.GetFEN(), board.GetFEN());
+  EXPECT_EQ(restored.Hash(), board.Hash());
+  EXPECT_EQ(restored.GetMaterial(chess::Colour::WHITE),
+            board.GetMaterial(chess::Colour::WHITE));
+}
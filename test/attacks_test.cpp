@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "attacks.hpp"
+
+#include <gtest/gtest.h>
+
+#include "board.hpp"
+
+TEST(AttacksTest, LeaperAttacks) {
+  const uint8_t a1 = chess::SquareIndex({0, 0});
+  const uint8_t d4 = chess::SquareIndex({3, 3});
+  const uint8_t h5 = chess::SquareIndex({7, 4});
+
+  EXPECT_EQ(chess::PopCount(chess::KNIGHT_ATTACKS[a1]), 2);
+  EXPECT_EQ(chess::PopCount(chess::KNIGHT_ATTACKS[d4]), 8);
+  EXPECT_EQ(chess::PopCount(chess::KNIGHT_ATTACKS[h5]), 4);
+
+  EXPECT_EQ(chess::PopCount(chess::KING_ATTACKS[a1]), 3);
+  EXPECT_EQ(chess::PopCount(chess::KING_ATTACKS[d4]), 8);
+  EXPECT_EQ(chess::PopCount(chess::KING_ATTACKS[h5]), 5);
+}
+
+TEST(AttacksTest, PawnAttacks) {
+  const uint8_t a2 = chess::SquareIndex({0, 1});
+  const uint8_t e4 = chess::SquareIndex({4, 3});
+
+  EXPECT_EQ(chess::PawnAttacks(chess::Colour::WHITE, a2),
+            chess::SquareBit(chess::SquareIndex({1, 2})));
+  EXPECT_EQ(chess::PawnAttacks(chess::Colour::BLACK, a2),
+            chess::SquareBit(chess::SquareIndex({1, 0})));
+  EXPECT_EQ(chess::PawnAttacks(chess::Colour::WHITE, e4),
+            chess::SquareBit(chess::SquareIndex({3, 4})) |
+                chess::SquareBit(chess::SquareIndex({5, 4})));
+}
+
+TEST(AttacksTest, ColourTraits) {
+  using White = chess::ColourTraits<chess::Colour::WHITE>;
+  using Black = chess::ColourTraits<chess::Colour::BLACK>;
+  static_assert(White::THEM == chess::Colour::BLACK);
+  static_assert(Black::PAWN_START_RANK == 6);
+  static_assert(Black::RelativeRank(Black::EN_PASSANT_RANK) ==
+                White::EN_PASSANT_RANK);
+
+  const chess::Bitboard e2 = chess::SquareBit(chess::SquareIndex({4, 1}));
+  EXPECT_EQ(chess::PawnPush<chess::Colour::WHITE>(e2),
+            chess::SquareBit(chess::SquareIndex({4, 2})));
+  EXPECT_EQ(chess::PawnPush<chess::Colour::BLACK>(e2),
+            chess::SquareBit(chess::SquareIndex({4, 0})));
+  EXPECT_EQ(chess::PawnPush<chess::Colour::WHITE>(chess::RankBitboard(7)),
+            chess::EMPTY_BITBOARD);
+}
+
+TEST(AttacksTest, LeaperMoves) {
+  chess::Board board;
+  board.SetPiece(chess::PieceType::KNIGHT, chess::Colour::WHITE, {1, 0});
+  board.SetPiece(chess::PieceType::PAWN, chess::Colour::WHITE, {3, 1});
+  board.SetPiece(chess::PieceType::PAWN, chess::Colour::BLACK, {2, 2});
+  board.SetPiece(chess::PieceType::PAWN, chess::Colour::WHITE, {7, 7});
+
+  // Nb1: a3, c3 (capture). d2 is taken by its own pawn.
+  chess::MoveList knight_moves;
+  board.GetMovesFrom({1, 0}, knight_moves);
+  EXPECT_EQ(knight_moves.Size(), 2);
+
+  // d2: d3, d4 and the capture on c3
+  chess::MoveList pawn_moves;
+  board.GetMovesFrom({3, 1}, pawn_moves);
+  EXPECT_EQ(pawn_moves.Size(), 3);
+
+  // A pawn in the last rank has nowhere to go.
+  chess::MoveList last_rank_moves;
+  board.GetMovesFrom({7, 7}, last_rank_moves);
+  EXPECT_TRUE(last_rank_moves.IsEmpty());
+}
@@ -19,15 +19,60 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 
+#include "perft.hpp"
+
 class BoardTest : public ::testing::Test {
  public:
   void SetUp() override { board = std::make_unique<chess::Board>(); }
 
  protected:
   std::unique_ptr<chess::Board> board;
+  chess::BoardHistory history;
+
+  void SetUpStartPosition() {
+    for (uint8_t i = 0; i < 8; ++i) {
+      board->SetPiece(std::make_unique<chess::Pawn>(chess::Colour::WHITE),
+                      {i, 1});
+      board->SetPiece(std::make_unique<chess::Pawn>(chess::Colour::BLACK),
+                      {i, 6});
+    }
+    board->SetPiece(std::make_unique<chess::Knight>(chess::Colour::WHITE),
+                    {1, 0});
+    board->SetPiece(std::make_unique<chess::Knight>(chess::Colour::WHITE),
+                    {6, 0});
+    board->SetPiece(std::make_unique<chess::Knight>(chess::Colour::BLACK),
+                    {1, 7});
+    board->SetPiece(std::make_unique<chess::Knight>(chess::Colour::BLACK),
+                    {6, 7});
+    board->SetPiece(std::make_unique<chess::Bishop>(chess::Colour::WHITE),
+                    {2, 0});
+    board->SetPiece(std::make_unique<chess::Bishop>(chess::Colour::WHITE),
+                    {5, 0});
+    board->SetPiece(std::make_unique<chess::Bishop>(chess::Colour::BLACK),
+                    {2, 7});
+    board->SetPiece(std::make_unique<chess::Bishop>(chess::Colour::BLACK),
+                    {5, 7});
+    board->SetPiece(std::make_unique<chess::Rook>(chess::Colour::WHITE),
+                    {0, 0});
+    board->SetPiece(std::make_unique<chess::Rook>(chess::Colour::WHITE),
+                    {7, 0});
+    board->SetPiece(std::make_unique<chess::Rook>(chess::Colour::BLACK),
+                    {0, 7});
+    board->SetPiece(std::make_unique<chess::Rook>(chess::Colour::BLACK),
+                    {7, 7});
+    board->SetPiece(std::make_unique<chess::Queen>(chess::Colour::WHITE),
+                    {3, 0});
+    board->SetPiece(std::make_unique<chess::Queen>(chess::Colour::BLACK),
+                    {3, 7});
+    board->SetPiece(std::make_unique<chess::King>(chess::Colour::WHITE),
+                    {4, 0});
+    board->SetPiece(std::make_unique<chess::King>(chess::Colour::BLACK),
+                    {4, 7});
+  }
 };
 
 TEST_F(BoardTest, GetFen) {
@@ -80,6 +125,47 @@ TEST_F(BoardTest, CanBeCaptured) {
   EXPECT_FALSE(board->CanBeCaptured({5, 4}));
 }
 
+TEST_F(BoardTest, IsSquareAttacked) {
+  board->SetPiece(chess::PieceType::PAWN, chess::Colour::WHITE, {3, 3});
+  board->SetPiece(chess::PieceType::KNIGHT, chess::Colour::BLACK, {5, 6});
+  board->SetPiece(chess::PieceType::ROOK, chess::Colour::BLACK, {0, 4});
+  board->SetPiece(chess::PieceType::BISHOP, chess::Colour::WHITE, {2, 4});
+
+  // Empty squares can be attacked too
+  EXPECT_TRUE(board->IsSquareAttacked({4, 4}, chess::Colour::WHITE));
+  EXPECT_TRUE(board->IsSquareAttacked({4, 4}, chess::Colour::BLACK));
+  EXPECT_FALSE(board->IsSquareAttacked({3, 4}, chess::Colour::WHITE));
+  EXPECT_TRUE(board->IsSquareAttacked({1, 4}, chess::Colour::BLACK));
+  EXPECT_FALSE(board->IsSquareAttacked({3, 4}, chess::Colour::BLACK));
+
+  const chess::Bitboard attackers = board->AttackersOf({4, 4});
+  EXPECT_EQ(attackers, chess::SquareBit(chess::SquareIndex(3, 3)) |
+                           chess::SquareBit(chess::SquareIndex(5, 6)));
+  EXPECT_EQ(board->AttackersOf({2, 4}),
+            chess::SquareBit(chess::SquareIndex(0, 4)) |
+                chess::SquareBit(chess::SquareIndex(3, 3)));
+}
+
+TEST_F(BoardTest, CannotCastleThroughCheck) {
+  board->SetPiece(chess::PieceType::KING, chess::Colour::WHITE, {4, 0});
+  board->SetPiece(chess::PieceType::ROOK, chess::Colour::WHITE, {0, 0});
+  board->SetPiece(chess::PieceType::ROOK, chess::Colour::WHITE, {7, 0});
+  board->SetPiece(chess::PieceType::KING, chess::Colour::BLACK, {4, 7});
+  board->SetPiece(chess::PieceType::BISHOP, chess::Colour::BLACK, {0, 5});
+  board->SetCastling(true, true, false, false);
+
+  // The bishop attacks f1, which the king crosses
+  EXPECT_FALSE(board->CanWKC());
+  EXPECT_TRUE(board->CanWQC());
+
+  // The b1 square is not crossed by the king
+  board->SetPiece(chess::PieceType::BISHOP, chess::Colour::BLACK, {0, 5});
+  board->SetPiece(chess::PieceType::KNIGHT, chess::Colour::BLACK, {0, 2});
+  EXPECT_TRUE(board->CanWQC());
+  board->SetPiece(chess::PieceType::KNIGHT, chess::Colour::BLACK, {1, 2});
+  EXPECT_FALSE(board->CanWQC());
+}
+
 TEST_F(BoardTest, IsInCheck) {
   board->SetPiece(std::make_unique<chess::King>(chess::Colour::WHITE), {2, 3});
   board->SetPiece(std::make_unique<chess::Pawn>(chess::Colour::WHITE), {3, 3});
@@ -111,3 +197,679 @@ TEST_F(BoardTest, KeepTrackOfTheKings) {
   ASSERT_TRUE(black_king_square.has_value());
   EXPECT_EQ(black_king_square.value(), (chess::Square{7, 6}));
 }
+
+TEST_F(BoardTest, CopyIsIndependent) {
+  board->SetPiece(chess::PieceType::KING, chess::Colour::WHITE, {4, 0});
+  board->SetPiece(chess::PieceType::ROOK, chess::Colour::BLACK, {4, 7});
+
+  chess::Board copy(*board);
+  copy.DoMove({{4, 7}, {4, 1}});
+
+  EXPECT_EQ(board->PieceAt(4, 1), nullptr);
+  ASSERT_NE(board->PieceAt(4, 7), nullptr);
+
+  ASSERT_NE(copy.PieceAt(4, 1), nullptr);
+  EXPECT_EQ(copy.PieceAt(4, 1)->GetType(), chess::PieceType::ROOK);
+  EXPECT_EQ(copy.PieceAt(4, 7), nullptr);
+}
+
+TEST_F(BoardTest, HistoryIsKeptApart) {
+  // Copies carry the position only, not the moves played on it
+  EXPECT_LT(sizeof(chess::Board), 512);
+
+  SetUpStartPosition();
+  chess::Board copy(*board);
+  for (const char* uci : {"g1f3", "g8f6", "f3g1", "f6g8"}) {
+    board->MakeMove(chess::UCIToMove(uci), history);
+  }
+  EXPECT_EQ(history.GetUndoDepth(), 4);
+  EXPECT_EQ(board->CountRepetitions(history), 1);
+  EXPECT_EQ(copy.CountRepetitions(chess::BoardHistory()), 0);
+
+  history.Clear();
+  EXPECT_EQ(history.GetUndoDepth(), 0);
+  EXPECT_EQ(board->CountRepetitions(history), 0);
+}
+
+TEST_F(BoardTest, MakeUnmakeMove) {
+  board->SetPiece(chess::PieceType::KING, chess::Colour::WHITE, {4, 0});
+  board->SetPiece(chess::PieceType::ROOK, chess::Colour::WHITE, {7, 0});
+  board->SetPiece(chess::PieceType::KING, chess::Colour::BLACK, {4, 7});
+  board->SetPiece(chess::PieceType::KNIGHT, chess::Colour::BLACK, {7, 6});
+  board->SetPiece(chess::PieceType::PAWN, chess::Colour::WHITE, {6, 6});
+  board->SetCastling(true, false, false, false);
+  const std::string position = board->GetPosition(chess::Colour::WHITE);
+
+  // Castling
+  board->MakeMove(chess::WHITE_KING_CASTLE, history);
+  EXPECT_EQ(board->GetPosition(chess::Colour::BLACK),
+            "4k3/6Pn/8/8/8/8/8/5RK1 b - -");
+  board->UnmakeMove(history);
+  EXPECT_EQ(board->GetPosition(chess::Colour::WHITE), position);
+  EXPECT_EQ(board->GetWhiteKing(), (chess::Square{4, 0}));
+
+  // Capture with promotion
+  board->MakeMove({{6, 6}, {7, 7}, true, chess::PieceType::KNIGHT}, history);
+  EXPECT_EQ(board->GetPosition(chess::Colour::BLACK),
+            "4k2N/7n/8/8/8/8/8/4K2R b K -");
+  board->MakeMove({{7, 6}, {5, 7}}, history);
+  board->UnmakeMove(history);
+  board->UnmakeMove(history);
+  EXPECT_EQ(board->GetPosition(chess::Colour::WHITE), position);
+}
+
+TEST_F(BoardTest, EnPassant) {
+  board->SetPiece(chess::PieceType::PAWN, chess::Colour::WHITE, {4, 1});
+  board->SetPiece(chess::PieceType::PAWN, chess::Colour::BLACK, {3, 3});
+  board->SetCastling(false, false, false, false);
+
+  board->MakeMove({{4, 1}, {4, 3}}, history);
+  ASSERT_TRUE(board->GetEnPassant().has_value());
+  EXPECT_EQ(board->GetEnPassant().value(), (chess::Square{4, 2}));
+  EXPECT_TRUE(board->IsValidMove({{3, 3}, {4, 2}}, chess::Colour::BLACK));
+
+  board->MakeMove({{3, 3}, {4, 2}}, history);
+  EXPECT_EQ(board->GetPosition(chess::Colour::WHITE),
+            "8/8/8/8/8/4p3/8/8 w - -");
+
+  board->UnmakeMove(history);
+  EXPECT_EQ(board->GetPosition(chess::Colour::BLACK),
+            "8/8/8/8/3pP3/8/8/8 b - e3");
+  board->UnmakeMove(history);
+  EXPECT_FALSE(board->GetEnPassant().has_value());
+}
+
+TEST_F(BoardTest, GenerateMoves) {
+  SetUpStartPosition();
+
+  chess::MoveList moves;
+  board->GenerateMoves(moves);
+  EXPECT_EQ(moves.Size(), 20);
+  EXPECT_TRUE(moves.Contains({{6, 0}, {5, 2}}));
+
+  board->MakeMove({{4, 1}, {4, 3}}, history);
+  EXPECT_EQ(board->GetSideToMove(), chess::Colour::BLACK);
+  moves.Clear();
+  board->GenerateMoves(moves);
+  EXPECT_EQ(moves.Size(), 20);
+  EXPECT_TRUE(moves.Contains({{4, 6}, {4, 4}}));
+
+  board->UnmakeMove(history);
+  EXPECT_EQ(board->GetSideToMove(), chess::Colour::WHITE);
+}
+
+TEST_F(BoardTest, GenerateLegalMovesWithPins) {
+  board->SetPiece(chess::PieceType::KING, chess::Colour::WHITE, {4, 0});
+  board->SetPiece(chess::PieceType::ROOK, chess::Colour::WHITE, {4, 1});
+  board->SetPiece(chess::PieceType::KNIGHT, chess::Colour::WHITE, {3, 1});
+  board->SetPiece(chess::PieceType::ROOK, chess::Colour::BLACK, {4, 7});
+  board->SetPiece(chess::PieceType::BISHOP, chess::Colour::BLACK, {0, 4});
+  board->SetPiece(chess::PieceType::KING, chess::Colour::BLACK, {7, 7});
+  board->SetCastling(false, false, false, false);
+
+  chess::MoveList moves;
+  board->GenerateLegalMoves(moves);
+
+  // The rook is pinned along the file and the knight along the diagonal, so
+  // the knight cannot move at all.
+  EXPECT_TRUE(moves.Contains({{4, 1}, {4, 7}}));
+  EXPECT_FALSE(moves.Contains({{4, 1}, {0, 1}}));
+  for (const chess::Move& move : moves) {
+    EXPECT_NE(move.src, (chess::Square{3, 1}));
+  }
+  EXPECT_EQ(moves.Size(), 6 + 3);
+}
+
+TEST_F(BoardTest, GenerateLegalMovesInCheck) {
+  board->SetPiece(chess::PieceType::KING, chess::Colour::WHITE, {4, 0});
+  board->SetPiece(chess::PieceType::ROOK, chess::Colour::WHITE, {0, 1});
+  board->SetPiece(chess::PieceType::ROOK, chess::Colour::BLACK, {4, 7});
+  board->SetPiece(chess::PieceType::KING, chess::Colour::BLACK, {7, 7});
+  board->SetCastling(false, false, false, false);
+
+  chess::MoveList moves;
+  board->GenerateLegalMoves(moves);
+
+  // The rook can only block, and the king cannot stay on the file
+  EXPECT_TRUE(moves.Contains({{0, 1}, {4, 1}}));
+  EXPECT_FALSE(moves.Contains({{0, 1}, {0, 2}}));
+  EXPECT_TRUE(moves.Contains({{4, 0}, {3, 0}}));
+  EXPECT_FALSE(moves.Contains({{4, 0}, {4, 1}}));
+  EXPECT_EQ(moves.Size(), 1 + 4);
+
+  // In double check only the king can move
+  board->SetPiece(chess::PieceType::KNIGHT, chess::Colour::BLACK, {3, 2});
+  moves.Clear();
+  board->GenerateLegalMoves(moves);
+  for (const chess::Move& move : moves) {
+    EXPECT_EQ(move.src, (chess::Square{4, 0}));
+  }
+  EXPECT_EQ(moves.Size(), 3);
+}
+
+TEST_F(BoardTest, GenerateLegalEnPassant) {
+  board->SetPiece(chess::PieceType::KING, chess::Colour::WHITE, {0, 4});
+  board->SetPiece(chess::PieceType::PAWN, chess::Colour::WHITE, {1, 4});
+  board->SetPiece(chess::PieceType::PAWN, chess::Colour::BLACK, {2, 6});
+  board->SetPiece(chess::PieceType::KING, chess::Colour::BLACK, {4, 7});
+  board->SetCastling(false, false, false, false);
+  board->SetSideToMove(chess::Colour::BLACK);
+  board->MakeMove({{2, 6}, {2, 4}}, history);
+
+  chess::MoveList moves;
+  board->GenerateLegalMoves(moves);
+  EXPECT_TRUE(moves.Contains({{1, 4}, {2, 5}}));
+  board->UnmakeMove(history);
+
+  // Capturing would leave the king in check along the rank
+  board->SetPiece(chess::PieceType::ROOK, chess::Colour::BLACK, {7, 4});
+  board->MakeMove({{2, 6}, {2, 4}}, history);
+  moves.Clear();
+  board->GenerateLegalMoves(moves);
+  EXPECT_FALSE(moves.Contains({{1, 4}, {2, 5}}));
+}
+
+TEST_F(BoardTest, GenerateLegalCastles) {
+  board->SetPiece(chess::PieceType::KING, chess::Colour::WHITE, {4, 0});
+  board->SetPiece(chess::PieceType::ROOK, chess::Colour::WHITE, {0, 0});
+  board->SetPiece(chess::PieceType::ROOK, chess::Colour::WHITE, {7, 0});
+  board->SetPiece(chess::PieceType::KING, chess::Colour::BLACK, {4, 7});
+  board->SetCastling(true, true, false, false);
+
+  chess::MoveList moves;
+  board->GenerateLegalMoves(moves);
+  EXPECT_TRUE(moves.Contains(chess::WHITE_KING_CASTLE));
+  EXPECT_TRUE(moves.Contains(chess::WHITE_QUEEN_CASTLE));
+
+  // The king cannot castle through an attacked square. The b1 square may be
+  // attacked, since the king does not cross it.
+  board->SetPiece(chess::PieceType::ROOK, chess::Colour::BLACK, {5, 7});
+  board->SetPiece(chess::PieceType::ROOK, chess::Colour::BLACK, {1, 7});
+  moves.Clear();
+  board->GenerateLegalMoves(moves);
+  EXPECT_FALSE(moves.Contains(chess::WHITE_KING_CASTLE));
+  EXPECT_TRUE(moves.Contains(chess::WHITE_QUEEN_CASTLE));
+}
+
+TEST_F(BoardTest, GenerateLegalPromotions) {
+  board->SetPiece(chess::PieceType::KING, chess::Colour::WHITE, {4, 0});
+  board->SetPiece(chess::PieceType::PAWN, chess::Colour::WHITE, {0, 6});
+  board->SetPiece(chess::PieceType::KING, chess::Colour::BLACK, {7, 7});
+  board->SetCastling(false, false, false, false);
+
+  chess::MoveList moves;
+  board->GenerateLegalMoves(moves);
+  EXPECT_EQ(moves.Size(), 5 + 4);
+  EXPECT_TRUE(moves.Contains(chess::UCIToMove("a7a8q")));
+  EXPECT_TRUE(moves.Contains(chess::UCIToMove("a7a8n")));
+}
+
+TEST_F(BoardTest, GenerateLegalMovesMatchesValidMoves) {
+  SetUpStartPosition();
+
+  for (const char* uci : {"e2e4", "d7d5", "e4d5", "d8d5", "b1c3", "d5e5",
+                          "g1e2", "e5e2", "f1e2"}) {
+    chess::MoveList pseudo_legal;
+    board->GenerateMoves(pseudo_legal);
+    chess::MoveList legal;
+    board->GenerateLegalMoves(legal);
+
+    std::size_t valid = 0;
+    for (const chess::Move& move : pseudo_legal) {
+      if (board->IsValidMove(move, board->GetSideToMove())) {
+        EXPECT_TRUE(legal.Contains(move)) << chess::MoveToUCI(move);
+        valid++;
+      }
+    }
+    EXPECT_EQ(legal.Size(), valid) << uci;
+
+    board->MakeMove(chess::UCIToMove(uci), history);
+  }
+}
+
+TEST_F(BoardTest, GenerateMovesForColour) {
+  ASSERT_TRUE(board->SetPosition(
+      "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1"));
+
+  chess::MoveList moves;
+  board->GenerateLegalMoves(moves);
+  chess::MoveList black_moves;
+  board->GenerateLegalMoves<chess::Colour::BLACK>(black_moves);
+  EXPECT_EQ(black_moves.Size(), 43);
+  EXPECT_TRUE(std::equal(moves.begin(), moves.end(), black_moves.begin(),
+                         black_moves.end()));
+
+  moves.Clear();
+  board->GenerateMoves(moves);
+  black_moves.Clear();
+  board->GenerateMoves<chess::Colour::BLACK>(black_moves);
+  EXPECT_TRUE(std::equal(moves.begin(), moves.end(), black_moves.begin(),
+                         black_moves.end()));
+}
+
+TEST_F(BoardTest, GenerateNoisyAndQuietMoves) {
+  for (const chess::PerftPosition& position : chess::PERFT_POSITIONS) {
+    ASSERT_TRUE(board->SetPosition(position.fen)) << position.name;
+
+    chess::MoveList all;
+    board->GenerateLegalMoves(all);
+    chess::MoveList noisy;
+    board->GenerateLegalMoves(noisy, chess::MoveGenType::NOISY);
+    chess::MoveList quiet;
+    board->GenerateLegalMoves(quiet, chess::MoveGenType::QUIET);
+
+    EXPECT_EQ(noisy.Size() + quiet.Size(), all.Size()) << position.name;
+    for (const chess::Move& move : noisy) {
+      EXPECT_TRUE(all.Contains(move)) << chess::MoveToUCI(move);
+      EXPECT_TRUE(board->IsNoisyMove(move)) << chess::MoveToUCI(move);
+    }
+    for (const chess::Move& move : quiet) {
+      EXPECT_TRUE(all.Contains(move)) << chess::MoveToUCI(move);
+      EXPECT_FALSE(board->IsNoisyMove(move)) << chess::MoveToUCI(move);
+    }
+  }
+
+  // Promotions without a capture are noisy, castling is quiet
+  ASSERT_TRUE(board->SetPosition("4k3/P7/8/8/8/8/8/4K2R w K - 0 1"));
+  chess::MoveList noisy;
+  board->GenerateLegalMoves(noisy, chess::MoveGenType::NOISY);
+  EXPECT_EQ(noisy.Size(), 4);
+  EXPECT_TRUE(noisy.Contains(chess::UCIToMove("a7a8q")));
+  chess::MoveList quiet;
+  board->GenerateLegalMoves(quiet, chess::MoveGenType::QUIET);
+  EXPECT_TRUE(quiet.Contains(chess::WHITE_KING_CASTLE));
+}
+
+TEST_F(BoardTest, DoMoveOutOfTurn) {
+  ASSERT_TRUE(board->SetPosition("r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1"));
+
+  // The move is played by the rules of the moving piece's colour
+  board->DoMove(chess::WHITE_KING_CASTLE);
+  EXPECT_EQ(board->GetPosition(chess::Colour::BLACK),
+            "r3k2r/8/8/8/8/8/8/R4RK1 b kq -");
+  EXPECT_EQ(board->Hash(), board->ComputeHash());
+}
+
+TEST_F(BoardTest, DoMoveFromEmptySquare) {
+  ASSERT_TRUE(board->SetPosition("4k3/8/8/8/8/8/8/4K3 w - - 0 1"));
+  const uint64_t hash = board->Hash();
+
+  board->DoMove({{0, 2}, {0, 3}});
+  EXPECT_EQ(board->GetFEN(), "4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+  EXPECT_EQ(board->Hash(), hash);
+}
+
+TEST_F(BoardTest, MaterialIsIncremental) {
+  // Castles, en passant, promotions and captures for both sides
+  ASSERT_TRUE(
+      board->SetPosition("r3k2r/1P6/8/3pP3/8/8/6p1/R3K2R w KQkq d6 0 1"));
+
+  const auto expect_same_totals = [](const chess::Board& a,
+                                     const chess::Board& b) {
+    for (const chess::Colour colour :
+         {chess::Colour::WHITE, chess::Colour::BLACK}) {
+      EXPECT_EQ(a.GetMaterial(colour), b.GetMaterial(colour));
+      EXPECT_EQ(a.GetPsqScore(colour), b.GetPsqScore(colour));
+      for (uint8_t type = 0; type < 6; ++type) {
+        const auto piece_type = static_cast<chess::PieceType>(type);
+        EXPECT_EQ(a.GetPieceCount(colour, piece_type),
+                  b.GetPieceCount(colour, piece_type));
+      }
+    }
+  };
+
+  chess::MoveList moves;
+  board->GenerateLegalMoves(moves);
+  for (const chess::Move& move : moves) {
+    board->MakeMove(move, history);
+    chess::MoveList replies;
+    board->GenerateLegalMoves(replies);
+    for (const chess::Move& reply : replies) {
+      board->MakeMove(reply, history);
+      chess::Board fresh;
+      ASSERT_TRUE(fresh.SetPosition(board->GetFEN()));
+      expect_same_totals(*board, fresh);
+      board->UnmakeMove(history);
+    }
+    board->UnmakeMove(history);
+  }
+
+  chess::Board fresh;
+  ASSERT_TRUE(fresh.SetPosition(board->GetFEN()));
+  expect_same_totals(*board, fresh);
+  EXPECT_EQ(board->GetMaterial(chess::Colour::WHITE),
+            2 * chess::ROOK_VALUE + 2 * chess::PAWN_VALUE);
+}
+
+TEST_F(BoardTest, AttackMap) {
+  // The e2 knight is pinned by the e8 rook and the king is checked by the b4
+  // bishop
+  ASSERT_TRUE(board->SetPosition("4r1k1/8/8/8/1b6/8/4N3/4K3 w - - 0 1"));
+
+  const chess::Board::AttackMap& attacks = board->GetAttackMap();
+  const auto bit = [](chess::Square square) {
+    return chess::SquareBit(chess::SquareIndex(square));
+  };
+  EXPECT_EQ(attacks.checkers, bit({1, 3}));
+  EXPECT_EQ(attacks.pinned, bit({4, 1}));
+  EXPECT_NE(attacks.attacked[1] & bit({4, 1}), chess::EMPTY_BITBOARD);
+  EXPECT_NE(attacks.attacked[1] & bit({4, 0}), chess::EMPTY_BITBOARD);
+  EXPECT_EQ(attacks.attacked[1] & bit({5, 0}), chess::EMPTY_BITBOARD);
+  EXPECT_TRUE(board->IsInCheck(chess::Colour::WHITE));
+
+  // Blocking with the pinned knight is not allowed; the king must move
+  EXPECT_FALSE(board->IsValidMove(chess::UCIToMove("e2c3"),
+                                  chess::Colour::WHITE));
+  EXPECT_FALSE(board->IsValidMove(chess::UCIToMove("e1d2"),
+                                  chess::Colour::WHITE));
+  EXPECT_TRUE(board->IsValidMove(chess::UCIToMove("e1f2"),
+                                 chess::Colour::WHITE));
+
+  // The map follows the board
+  board->MakeMove(chess::UCIToMove("e1f2"), history);
+  EXPECT_EQ(board->GetAttackMap().checkers, chess::EMPTY_BITBOARD);
+  EXPECT_FALSE(board->IsInCheck(chess::Colour::WHITE));
+  board->UnmakeMove(history);
+  EXPECT_EQ(board->GetAttackMap().checkers, bit({1, 3}));
+  board->ClearPieceAt({1, 3});
+  EXPECT_FALSE(board->IsInCheck(chess::Colour::WHITE));
+}
+
+TEST_F(BoardTest, StaticExchangeEvaluation) {
+  const auto see = [this](const char* fen, const char* uci) {
+    EXPECT_TRUE(board->SetPosition(fen));
+    return board->SEE(chess::UCIToMove(uci));
+  };
+
+  // Undefended queen
+  EXPECT_EQ(see("4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1", "d1d5"),
+            chess::QUEEN_VALUE);
+  // The queen takes a pawn defended by a pawn
+  EXPECT_EQ(see("4k3/8/4p3/3p4/8/8/8/3QK3 w - - 0 1", "d1d5"),
+            chess::PAWN_VALUE - chess::QUEEN_VALUE);
+  // A pawn takes a knight defended by a pawn
+  EXPECT_EQ(see("4k3/8/4p3/3n4/4P3/8/8/4K3 w - - 0 1", "e4d5"),
+            chess::KNIGHT_VALUE - chess::PAWN_VALUE);
+  // The rook behind the first one joins the exchange
+  EXPECT_EQ(see("4k3/3r4/8/3p4/8/8/3R4/3RK3 w - - 0 1", "d2d5"),
+            chess::PAWN_VALUE);
+  EXPECT_EQ(see("4k3/3r4/8/3p4/8/8/3R4/4K3 w - - 0 1", "d2d5"),
+            chess::PAWN_VALUE - chess::ROOK_VALUE);
+  // Quiet moves
+  EXPECT_EQ(see("4k3/8/8/8/8/8/8/3RK3 w - - 0 1", "d1d2"), 0);
+  EXPECT_EQ(see("4k3/8/8/8/8/4p3/8/3R3K w - - 0 1", "d1d2"),
+            -chess::ROOK_VALUE);
+  // En passant
+  EXPECT_EQ(see("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", "e5d6"),
+            chess::PAWN_VALUE);
+  // Promotions, undefended and defended
+  EXPECT_EQ(see("4k3/1P6/8/8/8/8/8/4K3 w - - 0 1", "b7b8q"),
+            chess::QUEEN_VALUE - chess::PAWN_VALUE);
+  EXPECT_EQ(see("r3k3/1P6/8/8/8/8/8/4K3 w - - 0 1", "b7b8q"),
+            -chess::PAWN_VALUE);
+  // The king only recaptures if the piece is no longer defended
+  EXPECT_EQ(see("3rk3/8/8/8/8/8/3p4/3RK3 w - - 0 1", "d1d2"),
+            chess::PAWN_VALUE);
+  EXPECT_EQ(see("3rk3/8/8/8/2n5/8/3p4/3RK3 w - - 0 1", "d1d2"),
+            chess::PAWN_VALUE - chess::ROOK_VALUE);
+}
+
+TEST_F(BoardTest, IsValidMoveMatchesLegalMoves) {
+  for (const chess::PerftPosition& position : chess::PERFT_POSITIONS) {
+    ASSERT_TRUE(board->SetPosition(position.fen));
+
+    chess::MoveList legal;
+    board->GenerateLegalMoves(legal);
+    chess::MoveList pseudo_legal;
+    board->GenerateMoves(pseudo_legal);
+    for (const chess::Move& move : pseudo_legal) {
+      EXPECT_EQ(board->IsValidMove(move, board->GetSideToMove()),
+                legal.Contains(move))
+          << position.name << " " << chess::MoveToUCI(move);
+    }
+  }
+}
+
+TEST_F(BoardTest, IsValidMoveEnPassantExposingKing) {
+  // Both pawns leave the fifth rank, opening it to the rook
+  ASSERT_TRUE(board->SetPosition("8/8/8/KPp4r/8/8/8/7k w - c6 0 1"));
+  EXPECT_FALSE(board->IsValidMove(chess::UCIToMove("b5c6"),
+                                  chess::Colour::WHITE));
+  EXPECT_TRUE(board->IsValidMove(chess::UCIToMove("b5b6"),
+                                 chess::Colour::WHITE));
+}
+
+TEST_F(BoardTest, Repetitions) {
+  SetUpStartPosition();
+
+  const auto play = [&](const char* uci) {
+    board->DoMove(chess::UCIToMove(uci), history);
+  };
+  for (const char* uci : {"g1f3", "g8f6", "f3g1", "f6g8"}) {
+    play(uci);
+  }
+  EXPECT_EQ(board->CountRepetitions(history), 1);
+  EXPECT_FALSE(board->IsThreefoldRepetition(history));
+
+  // Unmaking a move forgets its position
+  board->MakeMove(chess::UCIToMove("b1c3"), history);
+  EXPECT_EQ(board->CountRepetitions(history), 0);
+  board->UnmakeMove(history);
+  EXPECT_EQ(board->CountRepetitions(history), 1);
+
+  for (const char* uci : {"g1f3", "g8f6", "f3g1", "f6g8"}) {
+    play(uci);
+  }
+  EXPECT_EQ(board->CountRepetitions(history), 2);
+  EXPECT_TRUE(board->IsThreefoldRepetition(history));
+
+  // Only positions since the last pawn move are scanned
+  for (const char* uci : {"e2e3", "g8f6", "f1e2", "f6g8", "e2f1"}) {
+    play(uci);
+  }
+  EXPECT_EQ(board->GetHalfmoveClock(), 4);
+  EXPECT_EQ(board->CountRepetitions(history), 1);
+}
+
+TEST_F(BoardTest, FiftyMoveRule) {
+  ASSERT_TRUE(board->SetPosition("8/8/4k3/8/8/4K3/8/7R w - - 99 80"));
+  EXPECT_FALSE(board->IsFiftyMoveRule());
+
+  board->MakeMove(chess::UCIToMove("h1h2"), history);
+  EXPECT_TRUE(board->IsFiftyMoveRule());
+  board->UnmakeMove(history);
+
+  // Positions before the FEN are not known
+  EXPECT_EQ(board->CountRepetitions(history), 0);
+}
+
+TEST_F(BoardTest, HashIsIncremental) {
+  SetUpStartPosition();
+  const uint64_t start_hash = board->Hash();
+  EXPECT_EQ(start_hash, board->ComputeHash());
+
+  // Different move orders reaching the same position give the same key
+  for (const char* uci : {"g1f3", "g8f6", "b1c3", "b8c6"}) {
+    board->MakeMove(chess::UCIToMove(uci), history);
+    EXPECT_EQ(board->Hash(), board->ComputeHash());
+  }
+  const uint64_t knights_hash = board->Hash();
+  for (int i = 0; i < 4; ++i) {
+    board->UnmakeMove(history);
+  }
+  EXPECT_EQ(board->Hash(), start_hash);
+  for (const char* uci : {"b1c3", "b8c6", "g1f3", "g8f6"}) {
+    board->MakeMove(chess::UCIToMove(uci), history);
+  }
+  EXPECT_EQ(board->Hash(), knights_hash);
+
+  // The side to move, castling rights and en passant are part of the key
+  board->SetSideToMove(chess::Colour::BLACK);
+  EXPECT_NE(board->Hash(), knights_hash);
+  EXPECT_EQ(board->Hash(), board->ComputeHash());
+  board->SetSideToMove(chess::Colour::WHITE);
+  board->SetCastling(true, false, true, true);
+  EXPECT_NE(board->Hash(), knights_hash);
+  EXPECT_EQ(board->Hash(), board->ComputeHash());
+  board->SetCastling(true, true, true, true);
+  EXPECT_EQ(board->Hash(), knights_hash);
+
+  board->MakeMove(chess::UCIToMove("e2e4"), history);
+  const uint64_t en_passant_hash = board->Hash();
+  board->UnmakeMove(history);
+  board->DoMove(chess::UCIToMove("e2e4"));
+  EXPECT_EQ(board->Hash(), en_passant_hash);
+  EXPECT_EQ(board->Hash(), board->ComputeHash());
+
+  // Captures, castling and piece edits
+  for (const char* uci : {"f6e4", "c3e4", "d7d5", "f1e2", "d5e4", "e1g1"}) {
+    board->MakeMove(chess::UCIToMove(uci), history);
+    EXPECT_EQ(board->Hash(), board->ComputeHash()) << uci;
+  }
+  board->ClearPieceAt({3, 7});
+  EXPECT_EQ(board->Hash(), board->ComputeHash());
+  board->SetPiece(chess::PieceType::QUEEN, chess::Colour::WHITE, {3, 7});
+  EXPECT_EQ(board->Hash(), board->ComputeHash());
+}
+
+TEST_F(BoardTest, FromFEN) {
+  const chess::FenResult result = board->FromFEN(
+      "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w Kq c6 0 2");
+  ASSERT_TRUE(result.IsOk());
+  EXPECT_EQ(board->GetSideToMove(), chess::Colour::WHITE);
+  EXPECT_EQ(board->GetPosition(chess::Colour::WHITE),
+            "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w Kq c6");
+  ASSERT_TRUE(board->GetEnPassant().has_value());
+  EXPECT_EQ(board->GetEnPassant().value(), (chess::Square{2, 5}));
+  EXPECT_EQ(board->GetWhiteKing(), (chess::Square{4, 0}));
+  EXPECT_EQ(board->GetBlackKing(), (chess::Square{4, 7}));
+  EXPECT_EQ(board->GetHalfmoveClock(), 0);
+  EXPECT_EQ(board->GetFullmoveNumber(), 2);
+  EXPECT_EQ(board->Hash(), board->ComputeHash());
+
+  // The move counters are optional
+  ASSERT_TRUE(board->FromFEN("4k3/8/8/8/8/8/8/4K3 b - -").IsOk());
+  EXPECT_EQ(board->GetSideToMove(), chess::Colour::BLACK);
+  EXPECT_EQ(board->GetHalfmoveClock(), 0);
+  EXPECT_EQ(board->GetFullmoveNumber(), 1);
+
+  // Quiet moves advance the half-move clock and black moves the move number
+  ASSERT_TRUE(board->FromFEN("4k3/4p3/8/8/8/8/8/4K3 b - - 7 30").IsOk());
+  board->MakeMove({{4, 7}, {3, 7}}, history);
+  EXPECT_EQ(board->GetHalfmoveClock(), 8);
+  EXPECT_EQ(board->GetFullmoveNumber(), 31);
+  board->MakeMove({{4, 0}, {4, 1}}, history);
+  board->MakeMove({{4, 6}, {4, 4}}, history);
+  EXPECT_EQ(board->GetHalfmoveClock(), 0);
+  board->UnmakeMove(history);
+  board->UnmakeMove(history);
+  board->UnmakeMove(history);
+  EXPECT_EQ(board->GetHalfmoveClock(), 7);
+  EXPECT_EQ(board->GetFullmoveNumber(), 30);
+}
+
+TEST_F(BoardTest, FromFENErrors) {
+  const auto error_at = [this](const char* fen) {
+    const chess::FenResult result = board->FromFEN(fen);
+    return std::make_pair(result.error, result.offset);
+  };
+
+  EXPECT_EQ(error_at("rnbqkbnr/ppppxppp/8/8/8/8/PPPPPPPP/RNBQKBNR w - -"),
+            std::make_pair(chess::FenError::INVALID_PIECE, std::size_t{13}));
+  EXPECT_EQ(error_at("8/8/8/8/8/8/8/7 w - -").first,
+            chess::FenError::INVALID_RANK_LENGTH);
+  EXPECT_EQ(error_at("8/8/8/8/8/8/8/44p w - -").first,
+            chess::FenError::INVALID_RANK_LENGTH);
+  EXPECT_EQ(error_at("8/8/8/8/8/8/8 w - -").first,
+            chess::FenError::INVALID_RANK_COUNT);
+  EXPECT_EQ(error_at("8/8/8/8/8/8/8/8/8 w - -").first,
+            chess::FenError::INVALID_RANK_COUNT);
+  EXPECT_EQ(error_at("4k3/8/8/8/8/8/8/4K3 w -").first,
+            chess::FenError::MISSING_FIELD);
+  EXPECT_EQ(error_at("4k3/8/8/8/8/8/8/4K3 white - -"),
+            std::make_pair(chess::FenError::INVALID_SIDE_TO_MOVE,
+                           std::size_t{21}));
+  EXPECT_EQ(error_at("4k3/8/8/8/8/8/8/4K3 w KX -").first,
+            chess::FenError::INVALID_CASTLING);
+  EXPECT_EQ(error_at("4k3/8/8/8/8/8/8/4K3 w - e3").first,
+            chess::FenError::INVALID_EN_PASSANT);
+  EXPECT_EQ(error_at("4k3/8/8/8/8/8/8/4K3 w - e").first,
+            chess::FenError::INVALID_EN_PASSANT);
+  EXPECT_EQ(error_at("4k3/8/8/8/8/8/8/4K3 w - - x 1").first,
+            chess::FenError::INVALID_HALFMOVE_CLOCK);
+  EXPECT_EQ(error_at("4k3/8/8/8/8/8/8/4K3 w - - 0 99999").first,
+            chess::FenError::INVALID_FULLMOVE_NUMBER);
+  EXPECT_EQ(error_at("4k3/8/8/8/8/8/8/4K3 w - - 0 1 extra").first,
+            chess::FenError::TRAILING_CHARACTERS);
+
+  // A failed parse leaves an empty board, even after the counters were read
+  EXPECT_EQ(error_at("4k3/8/8/8/8/8/8/4K3 w - - 12 34 extra").first,
+            chess::FenError::TRAILING_CHARACTERS);
+  EXPECT_EQ(board->GetBitboards().GetOccupied(), chess::EMPTY_BITBOARD);
+  EXPECT_EQ(board->GetHalfmoveClock(), 0);
+  EXPECT_EQ(board->GetFullmoveNumber(), 1);
+  EXPECT_EQ(board->Hash(), board->ComputeHash());
+}
+
+TEST_F(BoardTest, FromFENRejectsKingCount) {
+  EXPECT_EQ(board->FromFEN("8/8/8/8/8/8/8/8 w - -").error,
+            chess::FenError::INVALID_KING_COUNT);
+  EXPECT_EQ(board->FromFEN("4k3/8/8/8/8/8/8/8 w - -").error,
+            chess::FenError::INVALID_KING_COUNT);
+  EXPECT_EQ(board->FromFEN("4k3/8/8/8/8/8/8/3KK3 w - -").error,
+            chess::FenError::INVALID_KING_COUNT);
+}
+
+TEST_F(BoardTest, FromFENRejectsTooManyPieces) {
+  // More moves than fit in a MoveList
+  EXPECT_EQ(board
+                ->FromFEN("n1n1n1nk/QPQPQPQQ/Q6Q/Q2Q3Q/Q6Q/Q6Q/Q6Q/QQQQQQQK "
+                          "w - - 0 1")
+                .error,
+            chess::FenError::TOO_MANY_PIECES);
+  EXPECT_EQ(board->FromFEN("4k3/8/8/8/8/Q7/QQQQQQQQ/QQQQQQQK w - -").error,
+            chess::FenError::TOO_MANY_PIECES);
+  EXPECT_TRUE(board->FromFEN("4k3/8/8/8/8/8/QQQQQQQQ/QQQQQQQK w - -").IsOk());
+}
+
+TEST_F(BoardTest, FromFENRejectsTooManyPawns) {
+  EXPECT_EQ(board->FromFEN("4k3/8/8/8/8/P7/PPPPPPPP/4K3 w - -").error,
+            chess::FenError::TOO_MANY_PAWNS);
+}
+
+TEST_F(BoardTest, FromFENRejectsPawnOnBackRank) {
+  EXPECT_EQ(board->FromFEN("4k3/8/8/8/8/8/8/P3K3 w - -").error,
+            chess::FenError::PAWN_ON_BACK_RANK);
+  EXPECT_EQ(board->FromFEN("p3k3/8/8/8/8/8/8/4K3 w - -").error,
+            chess::FenError::PAWN_ON_BACK_RANK);
+}
+
+TEST_F(BoardTest, WriteFEN) {
+  for (const char* fen :
+       {"rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w Kq c6 0 2",
+        "4k3/8/8/8/8/8/8/4K3 b - - 12 140",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - "
+        "0 1"}) {
+    ASSERT_TRUE(board->FromFEN(fen).IsOk());
+    chess::Board::FenBuffer buffer;
+    const std::size_t length = board->WriteFEN(buffer);
+    EXPECT_EQ(std::string(buffer.data(), length), fen);
+    EXPECT_EQ(buffer[length], '\0');
+    EXPECT_EQ(board->GetFEN(), fen);
+  }
+
+  // The counters follow the moves
+  ASSERT_TRUE(board->FromFEN(chess::STARTPOS_FEN).IsOk());
+  board->MakeMove(chess::UCIToMove("g1f3"), history);
+  board->MakeMove(chess::UCIToMove("g8f6"), history);
+  EXPECT_EQ(board->GetFEN(),
+            "rnbqkb1r/pppppppp/5n2/8/8/5N2/PPPPPPPP/RNBQKB1R w KQkq - 2 2");
+
+  // The longest possible FEN fits in the buffer
+  const std::string longest =
+      "k1q1q1q1/1q1q1q1q/q1q1q1q1/1q1q1q1q/Q1Q1Q1Q1/1Q1Q1Q1Q/Q1Q1Q1Q1/1Q1Q1Q1K "
+      "w KQkq e6 65535 65535";
+  EXPECT_EQ(longest.size(), chess::Board::MAX_FEN_LENGTH);
+  ASSERT_TRUE(board->FromFEN(longest).IsOk());
+  EXPECT_EQ(board->GetFEN(), longest);
+}
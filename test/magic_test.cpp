@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "magic.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace {
+
+chess::Bitboard SlowAttacks(uint8_t index, chess::Bitboard occupied,
+                            bool diagonal) {
+  chess::Bitboard attacks = chess::EMPTY_BITBOARD;
+  const std::vector<chess::Direction> directions =
+      diagonal ? std::vector<chess::Direction>{chess::Direction::UP_LEFT,
+                                               chess::Direction::UP_RIGHT,
+                                               chess::Direction::DOWN_LEFT,
+                                               chess::Direction::DOWN_RIGHT}
+               : std::vector<chess::Direction>{
+                     chess::Direction::UP, chess::Direction::DOWN,
+                     chess::Direction::LEFT, chess::Direction::RIGHT};
+
+  for (const auto direction : directions) {
+    for (uint8_t n = 1; n < 8; ++n) {
+      const chess::Square square = chess::GetSquareInDirection(
+          direction, n, chess::IndexToSquare(index));
+      if (!chess::IsValidSquare(square)) {
+        break;
+      }
+      const chess::Bitboard bit = chess::SquareBit(chess::SquareIndex(square));
+      attacks |= bit;
+      if ((occupied & bit) != chess::EMPTY_BITBOARD) {
+        break;
+      }
+    }
+  }
+
+  return attacks;
+}
+
+void ExpectAttacksMatchRays() {
+  std::mt19937_64 rng(1234);
+  for (int i = 0; i < 200; ++i) {
+    const chess::Bitboard occupied = rng() & rng();
+    for (uint8_t index = 0; index < chess::NUM_SQUARES; ++index) {
+      ASSERT_EQ(chess::RookAttacks(index, occupied),
+                SlowAttacks(index, occupied, false));
+      ASSERT_EQ(chess::BishopAttacks(index, occupied),
+                SlowAttacks(index, occupied, true));
+    }
+  }
+}
+
+}  // namespace
+
+TEST(MagicTest, EmptyBoard) {
+  const uint8_t d4 = chess::SquareIndex({3, 3});
+  EXPECT_EQ(chess::PopCount(chess::RookAttacks(d4, chess::EMPTY_BITBOARD)),
+            14);
+  EXPECT_EQ(chess::PopCount(chess::BishopAttacks(d4, chess::EMPTY_BITBOARD)),
+            13);
+  EXPECT_EQ(chess::PopCount(chess::QueenAttacks(d4, chess::EMPTY_BITBOARD)),
+            27);
+}
+
+TEST(MagicTest, MagicLookupsMatchRays) {
+  chess::InitSlidingAttacks(false);
+  EXPECT_FALSE(chess::IsUsingPext());
+  ExpectAttacksMatchRays();
+  chess::InitSlidingAttacks();
+}
+
+TEST(MagicTest, DefaultLookupsMatchRays) {
+  chess::InitSlidingAttacks();
+  ExpectAttacksMatchRays();
+}
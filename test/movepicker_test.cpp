@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "movepicker.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "perft.hpp"
+
+namespace {
+
+std::vector<chess::Move> PickAll(chess::MovePicker& picker) {
+  std::vector<chess::Move> moves;
+  while (const auto move = picker.Next()) {
+    moves.push_back(move.value());
+  }
+  return moves;
+}
+
+}  // namespace
+
+TEST(MovePickerTest, YieldsEveryLegalMoveOnce) {
+  const chess::MoveHistory history;
+  const chess::Killers killers{};
+
+  for (const chess::PerftPosition& position : chess::PERFT_POSITIONS) {
+    chess::Board board;
+    ASSERT_TRUE(board.SetPosition(position.fen)) << position.name;
+    chess::MoveList legal;
+    board.GenerateLegalMoves(legal);
+
+    // A hash move from a collision is not legal here and is dropped
+    for (const chess::PackedMove hash_move :
+         {chess::PackedMove(), board.PackMove(legal[legal.Size() - 1]),
+          chess::PackedMove(0, 63)}) {
+      chess::MovePicker picker(board, hash_move, killers, chess::PackedMove(),
+                               history);
+      const std::vector<chess::Move> picked = PickAll(picker);
+      ASSERT_EQ(picked.size(), legal.Size()) << position.name;
+      for (const chess::Move& move : picked) {
+        EXPECT_TRUE(legal.Contains(move)) << chess::MoveToUCI(move);
+        EXPECT_EQ(std::count(picked.begin(), picked.end(), move), 1);
+      }
+    }
+  }
+}
+
+TEST(MovePickerTest, Order) {
+  // White can take a rook with the knight or the queen, or a pawn
+  chess::Board board;
+  ASSERT_TRUE(board.SetPosition("4k3/8/2r5/3p4/1N6/8/2Q5/4K3 w - - 0 1"));
+
+  chess::MoveHistory history;
+  history.AddCutoff(chess::Colour::WHITE, chess::PackedMove(),
+                    chess::PackedMove(chess::UCIToMove("e1d1")), 5);
+  const chess::Killers killers{chess::PackedMove(chess::UCIToMove("b4a6")),
+                               chess::PackedMove(chess::UCIToMove("c2h7"))};
+  const chess::PackedMove hash_move =
+      board.PackMove(chess::UCIToMove("c2c3"));
+
+  chess::MovePicker picker(board, hash_move, killers, chess::PackedMove(),
+                           history);
+  const std::vector<chess::Move> picked = PickAll(picker);
+  ASSERT_GE(picked.size(), 8);
+  EXPECT_EQ(picked[0], chess::UCIToMove("c2c3"));
+  // Most valuable victim, then least valuable attacker
+  EXPECT_EQ(picked[1], chess::UCIToMove("b4c6"));
+  EXPECT_EQ(picked[2], chess::UCIToMove("c2c6"));
+  EXPECT_EQ(picked[3], chess::UCIToMove("b4d5"));
+  // Killers, then history
+  EXPECT_EQ(picked[4], chess::UCIToMove("b4a6"));
+  EXPECT_EQ(picked[5], chess::UCIToMove("c2h7"));
+  EXPECT_EQ(picked[6], chess::UCIToMove("e1d1"));
+}
+
+TEST(MovePickerTest, History) {
+  chess::MoveHistory history;
+  const chess::PackedMove move(12, 28);
+  const chess::PackedMove previous(52, 36);
+
+  history.AddCutoff(chess::Colour::WHITE, previous, move, 4);
+  EXPECT_EQ(history.GetScore(chess::Colour::WHITE, move), 16);
+  EXPECT_EQ(history.GetScore(chess::Colour::BLACK, move), 0);
+  EXPECT_EQ(history.GetCounterMove(previous), move);
+
+  history.AddFailure(chess::Colour::WHITE, move, 2);
+  EXPECT_EQ(history.GetScore(chess::Colour::WHITE, move), 12);
+
+  // Scores saturate
+  for (int i = 0; i < 1000; ++i) {
+    history.AddCutoff(chess::Colour::WHITE, previous, move, 60);
+  }
+  EXPECT_LE(history.GetScore(chess::Colour::WHITE, move),
+            chess::MoveHistory::MAX_SCORE);
+  EXPECT_GT(history.GetScore(chess::Colour::WHITE, move),
+            chess::MoveHistory::MAX_SCORE / 2);
+
+  history.Clear();
+  EXPECT_EQ(history.GetScore(chess::Colour::WHITE, move), 0);
+  EXPECT_TRUE(history.GetCounterMove(previous).IsNull());
+}
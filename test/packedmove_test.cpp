@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "packedmove.hpp"
+
+#include <gtest/gtest.h>
+
+#include "board.hpp"
+
+TEST(PackedMoveTest, Fields) {
+  constexpr chess::PackedMove move(12, 28);
+  static_assert(move.GetSrc() == 12);
+  static_assert(move.GetDst() == 28);
+  static_assert(move.GetFlag() == chess::PackedMove::Flag::NORMAL);
+
+  constexpr chess::PackedMove promotion(52, 61,
+                                        chess::PackedMove::Flag::PROMOTION,
+                                        chess::PieceType::ROOK);
+  EXPECT_TRUE(promotion.IsPromotion());
+  EXPECT_EQ(promotion.GetPromotionType(), chess::PieceType::ROOK);
+
+  EXPECT_TRUE(chess::PackedMove().IsNull());
+  EXPECT_FALSE(move.IsNull());
+  EXPECT_EQ(chess::PackedMove::FromRaw(move.GetRaw()), move);
+}
+
+TEST(PackedMoveTest, ConversionToMove) {
+  const chess::Move moves[] = {
+      {{3, 1}, {3, 3}},
+      {{6, 0}, {5, 2}},
+      {{0, 6}, {0, 7}, true, chess::PieceType::QUEEN},
+      {{4, 6}, {5, 7}, true, chess::PieceType::KNIGHT},
+      {{7, 1}, {7, 0}, true, chess::PieceType::BISHOP},
+  };
+
+  for (const auto& move : moves) {
+    const chess::PackedMove packed(move);
+    EXPECT_EQ(packed.ToMove(), move);
+    EXPECT_EQ(chess::MoveToUCI(packed), chess::MoveToUCI(move));
+    EXPECT_EQ(chess::UCIToPackedMove(chess::MoveToUCI(move)), packed);
+  }
+}
+
+TEST(PackedMoveTest, SpecialMoveFlags) {
+  chess::Board board;
+  board.SetPiece(chess::PieceType::KING, chess::Colour::WHITE, {4, 0});
+  board.SetPiece(chess::PieceType::ROOK, chess::Colour::WHITE, {7, 0});
+  board.SetPiece(chess::PieceType::PAWN, chess::Colour::WHITE, {4, 1});
+  board.SetPiece(chess::PieceType::PAWN, chess::Colour::BLACK, {3, 3});
+
+  EXPECT_EQ(board.PackMove(chess::WHITE_KING_CASTLE).GetFlag(),
+            chess::PackedMove::Flag::CASTLING);
+  EXPECT_EQ(board.PackMove({{4, 1}, {4, 3}}).GetFlag(),
+            chess::PackedMove::Flag::NORMAL);
+
+  board.DoMove({{4, 1}, {4, 3}});
+  const chess::PackedMove en_passant = board.PackMove({{3, 3}, {4, 2}});
+  EXPECT_EQ(en_passant.GetFlag(), chess::PackedMove::Flag::EN_PASSANT);
+  EXPECT_EQ(en_passant.ToMove(), (chess::Move{{3, 3}, {4, 2}}));
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "perft.hpp"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+// Deepest depth tested for each reference position, keeping every position
+// below a few hundred thousand nodes.
+constexpr std::array<uint8_t, chess::PERFT_POSITIONS.size()> TEST_DEPTHS{
+    4, 3, 5, 3, 3, 3};
+
+}  // namespace
+
+TEST(PerftTest, ReferencePositions) {
+  for (std::size_t i = 0; i < chess::PERFT_POSITIONS.size(); ++i) {
+    const chess::PerftPosition& position = chess::PERFT_POSITIONS[i];
+    chess::Board board;
+    ASSERT_TRUE(board.SetPosition(position.fen)) << position.name;
+    const uint64_t hash = board.Hash();
+
+    for (uint8_t depth = 1; depth <= TEST_DEPTHS[i]; ++depth) {
+      EXPECT_EQ(chess::Perft(board, depth), position.nodes[depth - 1])
+          << position.name << " at depth " << static_cast<int>(depth);
+    }
+    EXPECT_EQ(board.Hash(), hash) << position.name;
+  }
+}
+
+TEST(PerftTest, Divide) {
+  chess::Board board;
+  ASSERT_TRUE(board.SetPosition(chess::STARTPOS_FEN));
+
+  const auto entries = chess::PerftDivide(board, 3);
+  ASSERT_EQ(entries.size(), 20);
+
+  uint64_t nodes = 0;
+  for (const auto& entry : entries) {
+    nodes += entry.nodes;
+    if (entry.move == chess::UCIToMove("e2e4")) {
+      EXPECT_EQ(entry.nodes, 600);
+    }
+  }
+  EXPECT_EQ(nodes, 8902);
+}
+
+TEST(PerftTest, SetPositionRejectsInvalidFen) {
+  chess::Board board;
+  EXPECT_FALSE(board.SetPosition(""));
+  EXPECT_FALSE(board.SetPosition("8/8/8/8/8/8/8 w - -"));
+  EXPECT_FALSE(board.SetPosition("9/8/8/8/8/8/8/8 w - -"));
+  EXPECT_FALSE(board.SetPosition("8/8/8/8/8/8/8/8 x - -"));
+  EXPECT_FALSE(board.SetPosition("8/8/8/8/8/8/8/8 w X -"));
+  EXPECT_FALSE(board.SetPosition("8/8/8/8/8/8/8/8 w - e4"));
+  EXPECT_FALSE(board.SetPosition("8/8/8/8/8/8/8/8 w - -"));
+  EXPECT_TRUE(board.SetPosition("4k3/8/8/8/8/8/8/4K3 w - -"));
+}
+
+TEST(PerftTest, Parallel) {
+  chess::PerftTable table(1);
+
+  for (const chess::PerftPosition& position : chess::PERFT_POSITIONS) {
+    chess::Board board;
+    ASSERT_TRUE(board.SetPosition(position.fen)) << position.name;
+
+    for (chess::PerftTable* shared_table :
+         {&table, static_cast<chess::PerftTable*>(nullptr)}) {
+      uint64_t nodes = 0;
+      for (const auto& entry :
+           chess::ParallelPerftDivide(board, 3, 4, shared_table)) {
+        nodes += entry.nodes;
+      }
+      EXPECT_EQ(nodes, position.nodes[2]) << position.name;
+    }
+  }
+}
+
+TEST(PerftTest, Table) {
+  chess::PerftTable table(1);
+  uint64_t nodes = 0;
+  EXPECT_FALSE(table.Probe(0x1234, 3, &nodes));
+
+  table.Store(0x1234, 3, 8902);
+  ASSERT_TRUE(table.Probe(0x1234, 3, &nodes));
+  EXPECT_EQ(nodes, 8902);
+  EXPECT_FALSE(table.Probe(0x1234, 4, &nodes));
+
+  chess::Board board;
+  ASSERT_TRUE(board.SetPosition(chess::STARTPOS_FEN));
+  EXPECT_EQ(chess::Perft(board, 4, &table), 197281);
+  EXPECT_EQ(chess::Perft(board, 4, &table), 197281);
+}
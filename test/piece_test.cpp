@@ -19,6 +19,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <string>
+
 TEST(PieceTest, PieceInfo) {
   chess::Pawn wpawn(chess::Colour::WHITE);
   chess::Pawn bpawn(chess::Colour::BLACK);
@@ -55,3 +58,63 @@ TEST(PieceTest, PieceInfo) {
   EXPECT_EQ(king.GetValue(), chess::KING_VALUE);
   EXPECT_EQ(chess::KING_VALUE, 255);
 }
+
+TEST(PieceTest, PieceCode) {
+  const chess::PieceCode none;
+  EXPECT_TRUE(none.IsNone());
+  EXPECT_EQ(none.GetRaw(), chess::PieceCode::NONE);
+
+  const chess::PieceCode black_queen(chess::Colour::BLACK,
+                                     chess::PieceType::QUEEN);
+  EXPECT_FALSE(black_queen.IsNone());
+  EXPECT_EQ(black_queen.GetColour(), chess::Colour::BLACK);
+  EXPECT_EQ(black_queen.GetType(), chess::PieceType::QUEEN);
+  EXPECT_EQ(black_queen.GetValue(), chess::QUEEN_VALUE);
+  EXPECT_EQ(black_queen.GetFenChar(), 'q');
+
+  for (const char ch : std::string{"PNBRQKpnbrqk"}) {
+    EXPECT_EQ(chess::PieceCode::FromFenChar(ch).GetFenChar(), ch);
+  }
+  EXPECT_TRUE(chess::PieceCode::FromFenChar('x').IsNone());
+  EXPECT_TRUE(chess::PieceCode::FromFenChar('1').IsNone());
+
+  chess::Knight knight(chess::Colour::WHITE);
+  EXPECT_EQ(knight.GetCode(),
+            chess::PieceCode(chess::Colour::WHITE, chess::PieceType::KNIGHT));
+  EXPECT_EQ(knight.Clone()->GetCode(), knight.GetCode());
+  EXPECT_EQ(chess::Piece::Factory(chess::PieceType::KING, chess::Colour::BLACK)
+                ->GetFenChar(),
+            'k');
+}
+
+TEST(PieceTest, GetPieceMoves) {
+  chess::Board board;
+  ASSERT_TRUE(board.SetPosition(
+      "r3k2r/8/8/8/3Pp3/8/8/R3K2R b KQkq d3 0 1"));
+
+  EXPECT_TRUE(board.GetPiece({0, 4}).IsNone());
+  const chess::PieceCode pawn = board.GetPiece({4, 3});
+  ASSERT_EQ(pawn, chess::PieceCode(chess::Colour::BLACK,
+                                   chess::PieceType::PAWN));
+
+  chess::MoveList pawn_moves;
+  chess::GetPieceMoves(board, pawn, {4, 3}, pawn_moves);
+  EXPECT_EQ(pawn_moves.Size(), 2);
+  EXPECT_TRUE(pawn_moves.Contains({{4, 3}, {3, 2}}));
+
+  const chess::Square king_square{4, 7};
+  const chess::PieceCode king = board.GetPiece(king_square);
+  chess::MoveList king_moves;
+  chess::GetPieceMoves(board, king, king_square, king_moves);
+  EXPECT_EQ(king_moves.Size(), 7);
+  chess::MoveList king_moves_without_castles;
+  chess::GetPieceMoves(board, king, king_square, king_moves_without_castles,
+                       chess::Piece::FLAG_EXCLUDE_CASTLES);
+  EXPECT_EQ(king_moves_without_castles.Size(), 5);
+
+  // The compatibility path hands out the same moves.
+  chess::MoveList piece_moves;
+  board.PieceAt(king_square)->GetMoves(board, king_square, piece_moves);
+  EXPECT_TRUE(std::equal(king_moves.begin(), king_moves.end(),
+                         piece_moves.begin(), piece_moves.end()));
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "position.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(PositionTest, SquareIndex) {
+  EXPECT_EQ(chess::SquareIndex({0, 0}), 0);
+  EXPECT_EQ(chess::SquareIndex({7, 0}), 7);
+  EXPECT_EQ(chess::SquareIndex({0, 1}), 8);
+  EXPECT_EQ(chess::SquareIndex({7, 7}), 63);
+  EXPECT_EQ(chess::IndexToSquare(12), (chess::Square{4, 1}));
+}
+
+TEST(PositionTest, SetAndRemovePieces) {
+  chess::Position position;
+  EXPECT_EQ(position.GetOccupied(), chess::EMPTY_BITBOARD);
+
+  position.SetPiece(12, chess::Colour::WHITE, chess::PieceType::PAWN);
+  position.SetPiece(60, chess::Colour::BLACK, chess::PieceType::KING);
+
+  EXPECT_FALSE(position.IsEmpty(12));
+  EXPECT_EQ(position.GetType(12), chess::PieceType::PAWN);
+  EXPECT_EQ(position.GetColour(12), chess::Colour::WHITE);
+  EXPECT_EQ(position.GetType(60), chess::PieceType::KING);
+  EXPECT_EQ(position.GetColour(60), chess::Colour::BLACK);
+  EXPECT_EQ(position.GetPieces(chess::Colour::WHITE), chess::SquareBit(12));
+  EXPECT_EQ(position.GetPieces(chess::Colour::BLACK, chess::PieceType::KING),
+            chess::SquareBit(60));
+
+  // Replace a piece
+  position.SetPiece(12, chess::Colour::BLACK, chess::PieceType::QUEEN);
+  EXPECT_EQ(position.GetPieces(chess::PieceType::PAWN), chess::EMPTY_BITBOARD);
+  EXPECT_EQ(position.GetPieces(chess::Colour::WHITE), chess::EMPTY_BITBOARD);
+  EXPECT_EQ(position.GetPieces(chess::Colour::BLACK, chess::PieceType::QUEEN),
+            chess::SquareBit(12));
+
+  position.RemovePiece(12);
+  EXPECT_TRUE(position.IsEmpty(12));
+  EXPECT_EQ(position.GetOccupied(), chess::SquareBit(60));
+}
+
+TEST(PositionTest, MovePiece) {
+  chess::Position position;
+  position.SetPiece(6, chess::Colour::WHITE, chess::PieceType::KNIGHT);
+  position.MovePiece(6, 21);
+
+  EXPECT_TRUE(position.IsEmpty(6));
+  EXPECT_EQ(position.GetType(21), chess::PieceType::KNIGHT);
+  EXPECT_EQ(position.GetPieces(chess::Colour::WHITE, chess::PieceType::KNIGHT),
+            chess::SquareBit(21));
+}
+
+TEST(PositionTest, MaterialAndPsqScores) {
+  chess::Position position;
+  position.SetPiece(4, chess::Colour::WHITE, chess::PieceType::KING);
+  position.SetPiece(6, chess::Colour::WHITE, chess::PieceType::KNIGHT);
+  position.SetPiece(52, chess::Colour::BLACK, chess::PieceType::PAWN);
+
+  EXPECT_EQ(position.GetCount(chess::Colour::WHITE, chess::PieceType::KING),
+            1);
+  EXPECT_EQ(position.GetCount(chess::Colour::BLACK, chess::PieceType::PAWN),
+            1);
+  EXPECT_EQ(position.GetMaterial(chess::Colour::WHITE), chess::KNIGHT_VALUE);
+  EXPECT_EQ(position.GetMaterial(chess::Colour::BLACK), chess::PAWN_VALUE);
+  // Ke1 0, Ng1 -40, e7 pawn -20
+  EXPECT_EQ(position.GetPsqScore(chess::Colour::WHITE), -40);
+  EXPECT_EQ(position.GetPsqScore(chess::Colour::BLACK), -20);
+
+  // Ng1-f3 gains 50, e7xf3 loses the knight
+  position.MovePiece(6, 21);
+  EXPECT_EQ(position.GetPsqScore(chess::Colour::WHITE), 10);
+  position.RemovePiece(21);
+  position.MovePiece(52, 21);
+  EXPECT_EQ(position.GetCount(chess::Colour::WHITE, chess::PieceType::KNIGHT),
+            0);
+  EXPECT_EQ(position.GetMaterial(chess::Colour::WHITE), 0);
+  EXPECT_EQ(position.GetPsqScore(chess::Colour::WHITE), 0);
+  EXPECT_EQ(position.GetPsqScore(chess::Colour::BLACK),
+            chess::PieceSquareValue(chess::Colour::BLACK,
+                                    chess::PieceType::PAWN, 21));
+
+  position.Clear();
+  EXPECT_EQ(position.GetMaterial(chess::Colour::BLACK), 0);
+  EXPECT_EQ(position.GetPsqScore(chess::Colour::BLACK), 0);
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "search.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "perft.hpp"
+
+class SearchTest : public ::testing::Test {
+ public:
+  void SetUp() override { search = std::make_unique<chess::Search>(); }
+
+ protected:
+  std::unique_ptr<chess::Search> search;
+
+  chess::SearchResult SearchFEN(const char* fen, uint8_t depth) {
+    chess::Board board;
+    EXPECT_TRUE(board.SetPosition(fen));
+    return search->Run(board, {depth, 0});
+  }
+};
+
+TEST_F(SearchTest, Evaluate) {
+  chess::Board board;
+  ASSERT_TRUE(board.SetPosition(chess::STARTPOS_FEN));
+  EXPECT_EQ(chess::Evaluate(board), 0);
+
+  // An extra queen, seen from both sides
+  ASSERT_TRUE(board.SetPosition("4k3/8/8/8/8/8/8/3QK3 w - - 0 1"));
+  EXPECT_GT(chess::Evaluate(board), 800);
+  board.SetSideToMove(chess::Colour::BLACK);
+  EXPECT_LT(chess::Evaluate(board), -800);
+}
+
+TEST_F(SearchTest, CapturesHangingQueen) {
+  const auto result = SearchFEN("4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1", 3);
+  ASSERT_TRUE(result.bestmove.has_value());
+  EXPECT_EQ(result.bestmove.value(), chess::UCIToMove("d1d5"));
+}
+
+TEST_F(SearchTest, QuiescenceSeesRecapture) {
+  // Without resolving captures at the leaves, the queen would take a pawn
+  // defended by another pawn
+  const auto result = SearchFEN("4k3/8/4p3/3p4/8/8/8/3QK3 w - - 0 1", 1);
+  ASSERT_TRUE(result.bestmove.has_value());
+  EXPECT_NE(result.bestmove.value(), chess::UCIToMove("d1d5"));
+}
+
+TEST_F(SearchTest, MateInOne) {
+  const auto result = SearchFEN("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", 3);
+  ASSERT_TRUE(result.bestmove.has_value());
+  EXPECT_EQ(result.bestmove.value(), chess::UCIToMove("a1a8"));
+
+  const auto line = search->GetLine();
+  ASSERT_TRUE(line.has_value());
+  EXPECT_TRUE(line->mate_counter);
+  EXPECT_EQ(line->score, 1);
+  EXPECT_EQ(line->pv.size(), 1);
+}
+
+TEST_F(SearchTest, MatedInOne) {
+  // The only king move lets the rook mate on the back rank
+  SearchFEN("k7/8/1K6/8/8/8/8/7R b - - 0 1", 3);
+  const auto line = search->GetLine();
+  ASSERT_TRUE(line.has_value());
+  EXPECT_TRUE(line->mate_counter);
+  EXPECT_EQ(line->score, -1);
+}
+
+TEST_F(SearchTest, RepetitionOfGamePositions) {
+  // The white king has a single move, back to a position of the game
+  chess::Board board;
+  ASSERT_TRUE(board.SetPosition("7r/8/8/8/8/8/2k5/K7 w - - 0 1"));
+  search->Run(board, {1, 0});
+  ASSERT_TRUE(search->GetLine().has_value());
+  EXPECT_LT(search->GetLine()->score, 0);
+
+  chess::BoardHistory history;
+  for (const char* uci : {"a1a2", "h8h7", "a2a1", "h7h8"}) {
+    board.DoMove(chess::UCIToMove(uci), history);
+  }
+  search->Run(board, {1, 0}, &history);
+  ASSERT_TRUE(search->GetLine().has_value());
+  EXPECT_EQ(search->GetLine()->score, 0);
+}
+
+TEST_F(SearchTest, NoLegalMoves) {
+  // Stalemate
+  const auto result = SearchFEN("k7/2Q5/1K6/8/8/8/8/8 b - - 0 1", 4);
+  EXPECT_FALSE(result.bestmove.has_value());
+  EXPECT_FALSE(search->GetLine().has_value());
+}
+
+TEST_F(SearchTest, ReportsEveryDepth) {
+  std::vector<chess::SearchInfo> infos;
+  search->SetInfoCallback(
+      [&infos](const chess::SearchInfo& info) { infos.push_back(info); });
+
+  const auto result = SearchFEN(chess::STARTPOS_FEN.c_str(), 4);
+  ASSERT_EQ(infos.size(), 4);
+  for (uint8_t depth = 1; depth <= 4; ++depth) {
+    const chess::SearchInfo& info = infos[depth - 1];
+    EXPECT_EQ(info.depth, depth);
+    EXPECT_EQ(info.pv.size(), depth);
+    EXPECT_FALSE(info.mate_counter);
+  }
+  EXPECT_EQ(result.bestmove, infos.back().pv[0]);
+  EXPECT_EQ(result.ponder, infos.back().pv[1]);
+  EXPECT_EQ(search->GetNodes(), infos.back().nodes);
+}
+
+TEST_F(SearchTest, TimeLimit) {
+  chess::Board board;
+  ASSERT_TRUE(board.SetPosition(chess::STARTPOS_FEN));
+  const uint64_t hash = board.Hash();
+
+  // An unbounded depth ends only because of the clock
+  const auto result = search->Run(board, {chess::MAX_PLY, 50});
+  EXPECT_TRUE(result.bestmove.has_value());
+  ASSERT_TRUE(search->GetLine().has_value());
+  EXPECT_LT(search->GetLine()->depth, chess::MAX_PLY);
+  EXPECT_EQ(board.Hash(), hash);
+}
+
+TEST_F(SearchTest, HashReusesResults) {
+  chess::Board board;
+  ASSERT_TRUE(board.SetPosition(chess::PERFT_POSITIONS[1].fen));
+
+  const auto first = search->Run(board, {4, 0});
+  const uint64_t first_nodes = search->GetNodes();
+  const auto line = search->GetLine();
+
+  // The same search again finds most positions in the table
+  const auto second = search->Run(board, {4, 0});
+  EXPECT_LT(search->GetNodes(), first_nodes);
+  EXPECT_EQ(second.bestmove, first.bestmove);
+  EXPECT_EQ(search->GetLine()->score, line->score);
+
+  search->ClearHash();
+  search->Run(board, {4, 0});
+  EXPECT_EQ(search->GetNodes(), first_nodes);
+}
+
+TEST_F(SearchTest, Threads) {
+  search->SetNumThreads(4);
+  EXPECT_EQ(search->GetNumThreads(), 4);
+
+  const auto result = SearchFEN("6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1", 5);
+  ASSERT_TRUE(result.bestmove.has_value());
+  EXPECT_EQ(result.bestmove.value(), chess::UCIToMove("a1a8"));
+  EXPECT_TRUE(search->GetLine()->mate_counter);
+  EXPECT_EQ(search->GetLine()->depth, 5);
+
+  search->SetNumThreads(1);
+  EXPECT_EQ(search->GetNumThreads(), 1);
+}
+
+TEST_F(SearchTest, StopBeforeRun) {
+  chess::Board board;
+  ASSERT_TRUE(board.SetPosition(chess::STARTPOS_FEN));
+
+  // A search without limits returns because of the earlier stop
+  search->Stop();
+  search->Run(board, {});
+
+  // The stop was used up by that search
+  search->Run(board, {3, 0});
+  ASSERT_TRUE(search->GetLine().has_value());
+  EXPECT_EQ(search->GetLine()->depth, 3);
+}
+
+TEST_F(SearchTest, StopFromAnotherThread) {
+  search->SetNumThreads(2);
+  chess::Board board;
+  ASSERT_TRUE(board.SetPosition(chess::STARTPOS_FEN));
+
+  std::thread stopper([this] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    search->Stop();
+  });
+  const auto result = search->Run(board, {});
+  stopper.join();
+
+  EXPECT_TRUE(result.bestmove.has_value());
+  EXPECT_GT(search->GetNodes(), 0);
+}
@@ -1,6 +1,16 @@
 SOURCES += \
     $$PWD/notation_conversion_test.cpp \
     $$PWD/board_test.cpp \
+    $$PWD/position_test.cpp \
+    $$PWD/attacks_test.cpp \
+    $$PWD/magic_test.cpp \
+    $$PWD/packedmove_test.cpp \
+    $$PWD/perft_test.cpp \
+    $$PWD/threadpool_test.cpp \
+    $$PWD/arena_test.cpp \
+    $$PWD/transpositiontable_test.cpp \
+    $$PWD/movepicker_test.cpp \
+    $$PWD/search_test.cpp \
     $$PWD/piece_test.cpp
 
 SOURCES -= $$APP_MAIN
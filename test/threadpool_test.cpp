@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "threadpool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+TEST(ThreadPoolTest, RunsAllTasks) {
+  chess::ThreadPool pool(4);
+  EXPECT_EQ(pool.Size(), 4);
+
+  std::atomic<int> sum = 0;
+  for (int i = 1; i <= 1000; ++i) {
+    pool.Submit([&sum, i] { sum += i; });
+  }
+  pool.Wait();
+  EXPECT_EQ(sum, 500500);
+
+  // The pool can be reused after waiting
+  pool.Submit([&sum] { sum = 0; });
+  pool.Wait();
+  EXPECT_EQ(sum, 0);
+}
+
+TEST(ThreadPoolTest, WaitWithoutTasks) {
+  chess::ThreadPool pool;
+  EXPECT_GE(pool.Size(), 1);
+  pool.Wait();
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "transpositiontable.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using Bound = chess::TranspositionTable::Bound;
+
+TEST(TranspositionTableTest, StoreAndProbe) {
+  chess::TranspositionTable table(1);
+  chess::TranspositionTable::Entry entry;
+  EXPECT_FALSE(table.Probe(0x1234, &entry));
+
+  const chess::PackedMove move(12, 28);
+  table.Store(0x1234, {move, -2500, 7, Bound::LOWER});
+  ASSERT_TRUE(table.Probe(0x1234, &entry));
+  EXPECT_EQ(entry.move, move);
+  EXPECT_EQ(entry.score, -2500);
+  EXPECT_EQ(entry.depth, 7);
+  EXPECT_EQ(entry.bound, Bound::LOWER);
+
+  // A new result without a move keeps the old move
+  table.Store(0x1234, {chess::PackedMove(), 30, 8, Bound::UPPER});
+  ASSERT_TRUE(table.Probe(0x1234, &entry));
+  EXPECT_EQ(entry.move, move);
+  EXPECT_EQ(entry.score, 30);
+  EXPECT_EQ(entry.depth, 8);
+
+  table.Clear();
+  EXPECT_FALSE(table.Probe(0x1234, &entry));
+}
+
+TEST(TranspositionTableTest, Replacement) {
+  // A single bucket
+  chess::TranspositionTable table(0);
+  chess::TranspositionTable::Entry entry;
+
+  // Fill the bucket, then replace the shallowest entry
+  for (uint64_t key = 1; key <= 4; ++key) {
+    table.Store(key, {chess::PackedMove(), 0, static_cast<uint8_t>(key),
+                      Bound::EXACT});
+  }
+  table.Store(5, {chess::PackedMove(), 0, 10, Bound::EXACT});
+  EXPECT_FALSE(table.Probe(1, &entry));
+  EXPECT_TRUE(table.Probe(2, &entry));
+  EXPECT_TRUE(table.Probe(5, &entry));
+
+  // Entries of older searches go first, even if deeper
+  table.NewSearch();
+  EXPECT_EQ(table.Hashfull(), 0);
+  table.Store(6, {chess::PackedMove(), 0, 1, Bound::EXACT});
+  table.Store(7, {chess::PackedMove(), 0, 1, Bound::EXACT});
+  EXPECT_FALSE(table.Probe(2, &entry));
+  EXPECT_FALSE(table.Probe(3, &entry));
+  EXPECT_TRUE(table.Probe(5, &entry));
+  EXPECT_EQ(table.Hashfull(), 500);
+}
+
+TEST(TranspositionTableTest, ConcurrentWrites) {
+  chess::TranspositionTable table(1);
+
+  // Threads write different data for the same keys. Whatever is read back
+  // must be one of the written entries, never a mix of two.
+  std::vector<std::thread> threads;
+  for (uint8_t t = 1; t <= 4; ++t) {
+    threads.emplace_back([&table, t] {
+      for (uint64_t key = 1; key < 20000; ++key) {
+        table.Store(key * 0x9E3779B97F4A7C15ULL,
+                    {chess::PackedMove(t, t), t, t, Bound::EXACT});
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  chess::TranspositionTable::Entry entry;
+  for (uint64_t key = 1; key < 20000; ++key) {
+    if (table.Probe(key * 0x9E3779B97F4A7C15ULL, &entry)) {
+      EXPECT_EQ(entry.score, entry.depth);
+      EXPECT_EQ(entry.move, chess::PackedMove(entry.depth, entry.depth));
+    }
+  }
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (C) 2021  Javier Lancha Vázquez
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "board.hpp"
+#include "perft.hpp"
+
+namespace {
+
+constexpr uint8_t MAX_DEPTH = 20;
+constexpr uint8_t DEFAULT_SUITE_DEPTH = 5;
+constexpr long MAX_HASH_MB = 1 << 16;
+constexpr long MAX_THREADS = 1024;
+
+struct Options {
+  bool suite = false;
+  bool divide = false;
+  bool parallel = false;
+  std::size_t threads = 0;
+  std::size_t hash_mb = 0;
+  uint8_t depth = DEFAULT_SUITE_DEPTH;
+  std::string fen;
+};
+
+void PrintUsage() {
+  std::cerr << "Usage:\n"
+            << "  perft [options] [--divide] <depth> [fen]\n"
+            << "      Count the nodes of a position (start position by "
+               "default).\n"
+            << "  perft [options] --suite [depth]\n"
+            << "      Check the reference positions up to a depth (default "
+            << static_cast<int>(DEFAULT_SUITE_DEPTH) << ").\n"
+            << "Options:\n"
+            << "  --threads <n>  Count on n threads (0: all hardware "
+               "threads).\n"
+            << "  --hash <mb>    Reuse the counts of transposed subtrees, "
+               "with a table of mb MiB.\n";
+}
+
+bool ParseNumber(const char* str, long min, long max, long* number) {
+  char* end = nullptr;
+  const long value = std::strtol(str, &end, 10);
+  if ((*end != '\0') || (value < min) || (value > max)) {
+    return false;
+  }
+
+  *number = value;
+  return true;
+}
+
+bool ParseOptions(int argc, char* argv[], Options* options) {
+  std::vector<std::string_view> positional;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    long value = 0;
+    if (arg == "--suite") {
+      options->suite = true;
+    } else if (arg == "--divide") {
+      options->divide = true;
+    } else if (arg == "--threads") {
+      if ((++i >= argc) || !ParseNumber(argv[i], 0, MAX_THREADS, &value)) {
+        return false;
+      }
+      options->parallel = true;
+      options->threads = static_cast<std::size_t>(value);
+    } else if (arg == "--hash") {
+      if ((++i >= argc) || !ParseNumber(argv[i], 1, MAX_HASH_MB, &value)) {
+        return false;
+      }
+      options->hash_mb = static_cast<std::size_t>(value);
+    } else {
+      positional.push_back(arg);
+    }
+  }
+
+  // The FEN fields may be passed as separate arguments
+  for (std::size_t i = 0; i < positional.size(); ++i) {
+    long depth = 0;
+    if (i == 0) {
+      if (!ParseNumber(positional[i].data(), 1, MAX_DEPTH, &depth)) {
+        return false;
+      }
+      options->depth = static_cast<uint8_t>(depth);
+    } else {
+      if (!options->fen.empty()) {
+        options->fen += ' ';
+      }
+      options->fen += positional[i];
+    }
+  }
+  if (options->fen.empty()) {
+    options->fen = chess::STARTPOS_FEN;
+  }
+
+  return options->suite || !positional.empty();
+}
+
+double ElapsedSeconds(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+void PrintStats(uint64_t nodes, double seconds) {
+  std::cout << "Nodes: " << nodes << "\n"
+            << "Time: " << static_cast<uint64_t>(seconds * 1000) << " ms\n"
+            << "NPS: "
+            << static_cast<uint64_t>((seconds > 0) ? (nodes / seconds) : 0)
+            << "\n";
+}
+
+std::vector<chess::PerftDivideEntry> Divide(chess::Board& board,
+                                            uint8_t depth,
+                                            const Options& options,
+                                            chess::PerftTable* table) {
+  if (options.parallel) {
+    return chess::ParallelPerftDivide(board, depth, options.threads, table);
+  }
+
+  std::vector<chess::PerftDivideEntry> entries;
+  chess::MoveList moves;
+  board.GenerateLegalMoves(moves);
+  chess::BoardHistory history;
+  for (const chess::Move& move : moves) {
+    board.MakeMove(move, history);
+    entries.push_back({move, chess::Perft(board, depth - 1, table)});
+    board.UnmakeMove(history);
+  }
+
+  return entries;
+}
+
+uint64_t Count(chess::Board& board, uint8_t depth, const Options& options,
+               chess::PerftTable* table) {
+  if (!options.parallel) {
+    return chess::Perft(board, depth, table);
+  }
+
+  uint64_t nodes = 0;
+  for (const auto& entry : Divide(board, depth, options, table)) {
+    nodes += entry.nodes;
+  }
+  return nodes;
+}
+
+int RunPerft(const Options& options, chess::PerftTable* table) {
+  chess::Board board;
+  if (!board.SetPosition(options.fen)) {
+    std::cerr << "Invalid FEN: " << options.fen << "\n";
+    return EXIT_FAILURE;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  uint64_t nodes = 0;
+  if (options.divide) {
+    for (const auto& entry : Divide(board, options.depth, options, table)) {
+      std::cout << chess::MoveToUCI(entry.move) << ": " << entry.nodes
+                << "\n";
+      nodes += entry.nodes;
+    }
+    std::cout << "\n";
+  } else {
+    nodes = Count(board, options.depth, options, table);
+  }
+  PrintStats(nodes, ElapsedSeconds(start));
+
+  return EXIT_SUCCESS;
+}
+
+int RunSuite(const Options& options, chess::PerftTable* table) {
+  bool all_passed = true;
+  uint64_t total_nodes = 0;
+  const auto start = std::chrono::steady_clock::now();
+
+  for (const chess::PerftPosition& position : chess::PERFT_POSITIONS) {
+    chess::Board board;
+    board.SetPosition(position.fen);
+    std::cout << position.name << " (" << position.fen << ")\n";
+
+    for (uint8_t depth = 1;
+         (depth <= options.depth) && (depth <= position.nodes.size());
+         ++depth) {
+      const auto depth_start = std::chrono::steady_clock::now();
+      const uint64_t nodes = Count(board, depth, options, table);
+      const double seconds = ElapsedSeconds(depth_start);
+      const uint64_t expected = position.nodes[depth - 1];
+      const bool passed = (nodes == expected);
+
+      std::cout << "  depth " << static_cast<int>(depth) << ": " << nodes
+                << (passed ? " ok" : " FAILED, expected ")
+                << (passed ? "" : std::to_string(expected)) << " ("
+                << static_cast<uint64_t>(seconds * 1000) << " ms)\n";
+      all_passed = all_passed && passed;
+      total_nodes += nodes;
+    }
+  }
+
+  std::cout << "\n";
+  PrintStats(total_nodes, ElapsedSeconds(start));
+
+  return all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if ((argc == 2) && (std::string_view{argv[1]} == "--help")) {
+    PrintUsage();
+    return EXIT_SUCCESS;
+  }
+
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+
+  std::unique_ptr<chess::PerftTable> table;
+  if (options.hash_mb > 0) {
+    table = std::make_unique<chess::PerftTable>(options.hash_mb);
+  }
+
+  return options.suite ? RunSuite(options, table.get())
+                       : RunPerft(options, table.get());
+}